@@ -0,0 +1,130 @@
+// Global operator new / delete that feed alloc_tracker.h. Linked into the
+// game and the tests only; libraries and tools keep the default allocator.
+
+#include <cstdlib>
+#include <new>
+
+#include "alloc_tracker.h"
+
+namespace {
+
+void* allocate(std::size_t size) {
+  record_allocation(current_alloc_tag(), size);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocate_aligned(std::size_t size, std::align_val_t alignment) {
+  record_allocation(current_alloc_tag(), size);
+  std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+  return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+  // aligned_alloc needs the size to be a multiple of the alignment
+  std::size_t rounded = (size + align - 1) / align * align;
+  return std::aligned_alloc(align, rounded == 0 ? align : rounded);
+#endif
+}
+
+void deallocate(void* pointer) {
+  if (pointer) {
+    record_free(current_alloc_tag());
+    std::free(pointer);
+  }
+}
+
+void deallocate_aligned(void* pointer) {
+  if (pointer) {
+    record_free(current_alloc_tag());
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+  }
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (void* pointer = allocate(size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  if (void* pointer = allocate_aligned(size, alignment)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+  return allocate_aligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { deallocate(pointer); }
+
+void operator delete[](void* pointer) noexcept { deallocate(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+  deallocate_aligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+  deallocate_aligned(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+  deallocate_aligned(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+  deallocate_aligned(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+  deallocate_aligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+  deallocate_aligned(pointer);
+}
@@ -0,0 +1,86 @@
+#include "alloc_tracker.h"
+
+#include <atomic>
+
+namespace {
+
+struct AtomicCounters {
+  std::atomic<std::uint64_t> allocations{0};
+  std::atomic<std::uint64_t> bytes{0};
+  std::atomic<std::uint64_t> frees{0};
+};
+
+// Constant-initialized, so usable by allocations made before main()
+AtomicCounters g_counters[kAllocTagCount];
+thread_local AllocTag t_current_tag = AllocTag::Other;
+
+}  // namespace
+
+const char* alloc_tag_name(AllocTag tag) {
+  switch (tag) {
+    case AllocTag::Other:
+      return "Other";
+    case AllocTag::Render:
+      return "Render";
+    case AllocTag::UI:
+      return "UI";
+    case AllocTag::Logic:
+      return "Logic";
+    case AllocTag::Hints:
+      return "Hints";
+  }
+  return "Unknown";
+}
+
+AllocCounters AllocSnapshot::total() const {
+  AllocCounters sum;
+  for (const AllocCounters& counters : tags) {
+    sum.allocations += counters.allocations;
+    sum.bytes += counters.bytes;
+    sum.frees += counters.frees;
+  }
+  return sum;
+}
+
+AllocSnapshot alloc_snapshot() {
+  AllocSnapshot snapshot;
+  for (std::size_t i = 0; i < kAllocTagCount; ++i) {
+    const AtomicCounters& counters = g_counters[i];
+    snapshot.tags[i].allocations =
+        counters.allocations.load(std::memory_order_relaxed);
+    snapshot.tags[i].bytes = counters.bytes.load(std::memory_order_relaxed);
+    snapshot.tags[i].frees = counters.frees.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+AllocSnapshot alloc_difference(const AllocSnapshot& later,
+                               const AllocSnapshot& earlier) {
+  AllocSnapshot difference;
+  for (std::size_t i = 0; i < kAllocTagCount; ++i) {
+    difference.tags[i].allocations =
+        later.tags[i].allocations - earlier.tags[i].allocations;
+    difference.tags[i].bytes = later.tags[i].bytes - earlier.tags[i].bytes;
+    difference.tags[i].frees = later.tags[i].frees - earlier.tags[i].frees;
+  }
+  return difference;
+}
+
+AllocTag current_alloc_tag() { return t_current_tag; }
+
+AllocScope::AllocScope(AllocTag tag) : previous_(t_current_tag) {
+  t_current_tag = tag;
+}
+
+AllocScope::~AllocScope() { t_current_tag = previous_; }
+
+void record_allocation(AllocTag tag, std::size_t bytes) {
+  AtomicCounters& counters = g_counters[static_cast<std::size_t>(tag)];
+  counters.allocations.fetch_add(1, std::memory_order_relaxed);
+  counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void record_free(AllocTag tag) {
+  g_counters[static_cast<std::size_t>(tag)].frees.fetch_add(
+      1, std::memory_order_relaxed);
+}
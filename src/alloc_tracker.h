@@ -0,0 +1,66 @@
+#ifndef ALLOC_TRACKER_H_
+#define ALLOC_TRACKER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Heap allocation counters, per subsystem.
+//
+// Each thread charges its allocations to the subsystem set by the innermost
+// AllocScope. The counters are only fed when alloc_hooks.cpp, which replaces
+// the global operator new / delete, is linked into the executable; otherwise
+// they stay at zero.
+enum class AllocTag { Other, Render, UI, Logic, Hints };
+
+constexpr std::size_t kAllocTagCount = 5;
+
+// Name for display, e.g. "Render"
+const char* alloc_tag_name(AllocTag tag);
+
+struct AllocCounters {
+  std::uint64_t allocations = 0;
+  std::uint64_t bytes = 0;
+  std::uint64_t frees = 0;
+};
+
+// Counters of every subsystem at one point in time, indexed by AllocTag
+struct AllocSnapshot {
+  std::array<AllocCounters, kAllocTagCount> tags;
+
+  const AllocCounters& operator[](AllocTag tag) const {
+    return tags[static_cast<std::size_t>(tag)];
+  }
+
+  // Sums over all subsystems
+  AllocCounters total() const;
+};
+
+// Counts since the start of the program
+AllocSnapshot alloc_snapshot();
+
+// Counts between two snapshots
+AllocSnapshot alloc_difference(const AllocSnapshot& later,
+                               const AllocSnapshot& earlier);
+
+// Subsystem the calling thread is charging allocations to
+AllocTag current_alloc_tag();
+
+// Charges the calling thread's allocations to `tag` while in scope
+class AllocScope {
+ public:
+  explicit AllocScope(AllocTag tag);
+  ~AllocScope();
+
+  AllocScope(const AllocScope&) = delete;
+  AllocScope& operator=(const AllocScope&) = delete;
+
+ private:
+  AllocTag previous_;
+};
+
+// Called by the allocation hooks. Must not allocate.
+void record_allocation(AllocTag tag, std::size_t bytes);
+void record_free(AllocTag tag);
+
+#endif  // ALLOC_TRACKER_H_
@@ -0,0 +1,401 @@
+#include "board_corpus.h"
+
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+#include <zlib.h>
+
+#include "trace.h"
+
+namespace {
+
+constexpr unsigned char kMagic[4] = {'M', 'S', 'B', 'C'};
+constexpr unsigned char kIndexMagic[4] = {'M', 'S', 'B', 'I'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kFlagLabels = 1;
+
+// Header: magic, version, rows, columns, bombs, flags, boards per block
+constexpr std::size_t kHeaderSize = 28;
+// Index entry: offset (u64), compressed size (u32), board count (u32)
+constexpr std::size_t kIndexEntrySize = 16;
+// Footer: index offset (u64), block count (u64), board count (u64), magic
+constexpr std::size_t kFooterSize = 28;
+
+// Record: seed (u64), bomb bits, then 4 x u32 labels if present
+constexpr std::size_t kLabelsSize = 16;
+
+// Blocks are capped so huge boards don't need huge buffers, and so a block
+// always fits zlib's 32-bit lengths
+constexpr std::size_t kMaxBlockBytes = std::size_t{64} << 20;
+
+void put_u32(unsigned char* out, std::uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    out[i] = static_cast<unsigned char>(value >> (8 * i));
+  }
+}
+
+std::uint32_t get_u32(const unsigned char* in) {
+  std::uint32_t value = 0;
+  for (int i = 0; i < 4; ++i) {
+    value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+  }
+  return value;
+}
+
+void put_u64(unsigned char* out, std::uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    out[i] = static_cast<unsigned char>(value >> (8 * i));
+  }
+}
+
+std::uint64_t get_u64(const unsigned char* in) {
+  std::uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+  }
+  return value;
+}
+
+std::size_t bits_size(const GameSettings& settings) {
+  return (std::size_t{settings.rows} * settings.columns + 7) / 8;
+}
+
+std::size_t record_size(const GameSettings& settings, bool labels) {
+  return 8 + bits_size(settings) + (labels ? kLabelsSize : 0);
+}
+
+bool seek(std::FILE* file, std::uint64_t offset) {
+#ifdef _WIN32
+  return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+  return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+}  // namespace
+
+CorpusWriter::~CorpusWriter() { close(); }
+
+bool CorpusWriter::open(const std::string& path, const GameSettings& settings,
+                        bool labels, unsigned int boards_per_block) {
+  close();
+  if (!settings.is_valid() || boards_per_block == 0) {
+    return false;
+  }
+
+  settings_ = settings;
+  labels_ = labels;
+  record_size_ = record_size(settings, labels);
+  boards_per_block_ = static_cast<unsigned int>(std::max<std::size_t>(
+      1, std::min<std::size_t>(boards_per_block,
+                               kMaxBlockBytes / record_size_)));
+  board_count_ = 0;
+  offset_ = 0;
+  failed_ = false;
+  block_.clear();
+  block_.reserve(boards_per_block_ * record_size_);
+  block_boards_ = 0;
+  bits_.assign(bits_size(settings), 0);
+  index_.clear();
+
+  file_ = std::fopen(path.c_str(), "wb");
+  if (!file_) {
+    std::cerr << "Cannot create board corpus " << path << std::endl;
+    return false;
+  }
+
+  unsigned char header[kHeaderSize];
+  std::copy(kMagic, kMagic + 4, header);
+  put_u32(header + 4, kVersion);
+  put_u32(header + 8, settings.rows);
+  put_u32(header + 12, settings.columns);
+  put_u32(header + 16, settings.bombs);
+  put_u32(header + 20, labels ? kFlagLabels : 0);
+  put_u32(header + 24, boards_per_block_);
+  return write(header, kHeaderSize);
+}
+
+bool CorpusWriter::append(const GameBoard& board, const BoardLabels* labels) {
+  if (!file_ || board.get_rows() != settings_.rows ||
+      board.get_columns() != settings_.columns ||
+      board.get_bombs() != settings_.bombs ||
+      !board.store_bombs(bits_.data())) {
+    return false;
+  }
+  return append(bits_.data(), board.get_seed(), labels);
+}
+
+bool CorpusWriter::append(const std::uint8_t* bits, std::uint64_t seed,
+                          const BoardLabels* labels) {
+  if (!file_ || failed_ || (labels_ && !labels)) {
+    return false;
+  }
+
+  std::size_t offset = block_.size();
+  block_.resize(offset + record_size_);
+  unsigned char* out = block_.data() + offset;
+  put_u64(out, seed);
+  std::copy(bits, bits + bits_.size(), out + 8);
+  if (labels_) {
+    out += 8 + bits_.size();
+    put_u32(out, labels->bbbv);
+    put_u32(out + 4, labels->openings);
+    put_u32(out + 8, labels->islands);
+    put_u32(out + 12, labels->largest_opening);
+  }
+  ++board_count_;
+
+  if (++block_boards_ == boards_per_block_) {
+    return flush_block();
+  }
+  return true;
+}
+
+bool CorpusWriter::close() {
+  if (!file_) {
+    return false;
+  }
+  if (block_boards_ > 0) {
+    flush_block();
+  }
+
+  const std::uint64_t index_offset = offset_;
+  std::vector<unsigned char> index(index_.size() * kIndexEntrySize);
+  for (std::size_t i = 0; i < index_.size(); ++i) {
+    unsigned char* entry = index.data() + i * kIndexEntrySize;
+    put_u64(entry, index_[i].offset);
+    put_u32(entry + 8, index_[i].compressed_size);
+    put_u32(entry + 12, index_[i].board_count);
+  }
+  write(index.data(), index.size());
+
+  unsigned char footer[kFooterSize];
+  put_u64(footer, index_offset);
+  put_u64(footer + 8, index_.size());
+  put_u64(footer + 16, board_count_);
+  std::copy(kIndexMagic, kIndexMagic + 4, footer + 24);
+  write(footer, kFooterSize);
+
+  if (std::fclose(file_) != 0) {
+    failed_ = true;
+  }
+  file_ = nullptr;
+  if (failed_) {
+    std::cerr << "Failed to write the board corpus" << std::endl;
+  }
+  return !failed_;
+}
+
+bool CorpusWriter::write(const void* data, std::size_t size) {
+  if (failed_) {
+    return false;
+  }
+  if (size > 0 && std::fwrite(data, 1, size, file_) != size) {
+    failed_ = true;
+    return false;
+  }
+  offset_ += size;
+  return true;
+}
+
+bool CorpusWriter::flush_block() {
+  TRACE_SCOPE("CorpusWriter::flush_block");
+  uLongf compressed_size = compressBound(static_cast<uLong>(block_.size()));
+  compressed_.resize(compressed_size);
+  if (compress2(compressed_.data(), &compressed_size, block_.data(),
+                static_cast<uLong>(block_.size()),
+                Z_DEFAULT_COMPRESSION) != Z_OK) {
+    failed_ = true;
+    return false;
+  }
+
+  index_.push_back(CorpusBlockEntry{
+      offset_, static_cast<std::uint32_t>(compressed_size), block_boards_});
+  block_.clear();
+  block_boards_ = 0;
+  return write(compressed_.data(), compressed_size);
+}
+
+CorpusReader::~CorpusReader() {
+  if (file_) {
+    std::fclose(file_);
+  }
+}
+
+bool CorpusReader::open(const std::string& path) {
+  if (file_) {
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+  index_.clear();
+  block_loaded_ = false;
+  block_boards_ = 0;
+
+  std::error_code error;
+  const std::uintmax_t file_size = std::filesystem::file_size(path, error);
+  if (error || file_size < kHeaderSize + kFooterSize) {
+    std::cerr << "Cannot read board corpus " << path << std::endl;
+    return false;
+  }
+  file_ = std::fopen(path.c_str(), "rb");
+  if (!file_) {
+    std::cerr << "Cannot read board corpus " << path << std::endl;
+    return false;
+  }
+
+  auto fail = [&](const char* reason) {
+    std::cerr << "Invalid board corpus " << path << ": " << reason
+              << std::endl;
+    std::fclose(file_);
+    file_ = nullptr;
+    index_.clear();
+    return false;
+  };
+
+  unsigned char header[kHeaderSize];
+  if (std::fread(header, 1, kHeaderSize, file_) != kHeaderSize ||
+      !std::equal(kMagic, kMagic + 4, header)) {
+    return fail("not a board corpus");
+  }
+  if (get_u32(header + 4) != kVersion) {
+    return fail("unsupported version");
+  }
+  const std::uint32_t rows = get_u32(header + 8);
+  const std::uint32_t columns = get_u32(header + 12);
+  const std::uint32_t bombs = get_u32(header + 16);
+  const std::uint32_t flags = get_u32(header + 20);
+  boards_per_block_ = get_u32(header + 24);
+  // The same limits as GameBoard::change_settings(), which load_board() calls
+  settings_ = GameSettings::from_dimensions(rows, columns, bombs);
+  if (!settings_.is_valid() || (flags & ~kFlagLabels) != 0 ||
+      boards_per_block_ == 0) {
+    return fail("bad header");
+  }
+  labels_ = (flags & kFlagLabels) != 0;
+  record_size_ = record_size(settings_, labels_);
+  if (std::uint64_t{boards_per_block_} * record_size_ >
+      std::max<std::size_t>(kMaxBlockBytes, record_size_)) {
+    return fail("bad header");
+  }
+
+  unsigned char footer[kFooterSize];
+  if (!seek(file_, file_size - kFooterSize) ||
+      std::fread(footer, 1, kFooterSize, file_) != kFooterSize ||
+      !std::equal(kIndexMagic, kIndexMagic + 4, footer + 24)) {
+    return fail("missing index, the file may be truncated");
+  }
+  const std::uint64_t index_offset = get_u64(footer);
+  const std::uint64_t block_count = get_u64(footer + 8);
+  board_count_ = get_u64(footer + 16);
+  const std::uint64_t index_end = file_size - kFooterSize;
+  if (index_offset < kHeaderSize || index_offset > index_end ||
+      block_count != (index_end - index_offset) / kIndexEntrySize ||
+      (index_end - index_offset) % kIndexEntrySize != 0) {
+    return fail("bad index");
+  }
+
+  std::vector<unsigned char> index(block_count * kIndexEntrySize);
+  if (!seek(file_, index_offset) ||
+      std::fread(index.data(), 1, index.size(), file_) != index.size()) {
+    return fail("bad index");
+  }
+  index_.resize(block_count);
+  std::uint64_t boards = 0;
+  for (std::size_t i = 0; i < index_.size(); ++i) {
+    const unsigned char* entry = index.data() + i * kIndexEntrySize;
+    CorpusBlockEntry& block = index_[i];
+    block.offset = get_u64(entry);
+    block.compressed_size = get_u32(entry + 8);
+    block.board_count = get_u32(entry + 12);
+    // Every block but the last is full, so board i is in block i / per block
+    bool last = i + 1 == index_.size();
+    if (block.offset < kHeaderSize ||
+        block.offset + block.compressed_size > index_offset ||
+        block.board_count == 0 || block.board_count > boards_per_block_ ||
+        (!last && block.board_count != boards_per_block_)) {
+      return fail("bad index");
+    }
+    boards += block.board_count;
+  }
+  if (boards != board_count_) {
+    return fail("bad index");
+  }
+  return true;
+}
+
+bool CorpusReader::load_block(std::size_t block) {
+  TRACE_SCOPE("CorpusReader::load_block");
+  if (!file_ || block >= index_.size()) {
+    return false;
+  }
+  if (block_loaded_ && loaded_block_ == block) {
+    return true;
+  }
+  block_loaded_ = false;
+  block_boards_ = 0;
+
+  const CorpusBlockEntry& entry = index_[block];
+  compressed_.resize(entry.compressed_size);
+  if (!seek(file_, entry.offset) ||
+      std::fread(compressed_.data(), 1, compressed_.size(), file_) !=
+          compressed_.size()) {
+    return false;
+  }
+  const std::size_t expected = entry.board_count * record_size_;
+  block_.resize(expected);
+  uLongf size = static_cast<uLongf>(expected);
+  if (uncompress(block_.data(), &size, compressed_.data(),
+                 static_cast<uLong>(compressed_.size())) != Z_OK ||
+      size != expected) {
+    std::cerr << "Corrupt board corpus block " << block << std::endl;
+    return false;
+  }
+
+  loaded_block_ = block;
+  block_loaded_ = true;
+  block_boards_ = entry.board_count;
+  block_first_board_ = std::uint64_t{boards_per_block_} * block;
+  return true;
+}
+
+bool CorpusReader::load_board(unsigned int i, GameBoard& board,
+                              BoardLabels* labels) const {
+  if (i >= block_boards_) {
+    return false;
+  }
+  if (board.get_rows() != settings_.rows ||
+      board.get_columns() != settings_.columns ||
+      board.get_bombs() != settings_.bombs) {
+    if (!board.change_settings(settings_)) {
+      return false;
+    }
+  }
+
+  const unsigned char* record = block_.data() + i * record_size_;
+  const std::size_t bits = bits_size(settings_);
+  if (!board.load_bombs(record + 8, get_u64(record))) {
+    return false;
+  }
+  if (labels_ && labels) {
+    const unsigned char* in = record + 8 + bits;
+    labels->bbbv = get_u32(in);
+    labels->openings = get_u32(in + 4);
+    labels->islands = get_u32(in + 8);
+    labels->largest_opening = get_u32(in + 12);
+  }
+  return true;
+}
+
+bool CorpusReader::read_board(std::uint64_t index, GameBoard& board,
+                              BoardLabels* labels) {
+  if (index >= board_count_) {
+    return false;
+  }
+  std::size_t block = static_cast<std::size_t>(index / boards_per_block_);
+  if (!load_block(block)) {
+    return false;
+  }
+  return load_board(static_cast<unsigned int>(index - block_first_board_),
+                    board, labels);
+}
@@ -0,0 +1,217 @@
+#ifndef BOARD_CORPUS_H_
+#define BOARD_CORPUS_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game_board.h"
+#include "game_settings.h"
+
+// Compressed corpus of generated boards, so training can stream millions of
+// boards instead of generating them again every epoch.
+//
+// A board is stored as its seed and its bombs, one bit per cell in the
+// format of GameBoard::load_bombs(), optionally followed by BoardLabels.
+// Records are grouped into blocks of a fixed number of boards, and each
+// block is compressed with zlib on its own. The block index at the end of
+// the file gives random access to any board by decompressing one block.
+//
+// File layout, little-endian:
+//   header  "MSBC", version, rows, columns, bombs, flags, boards per block
+//   blocks  one zlib stream of records each
+//   index   per block: file offset, compressed size, board count
+//   footer  index offset, block count, board count, "MSBI"
+
+// Labels stored with a board, from BoardAnalyzer (see board_metrics.h)
+struct BoardLabels {
+  std::uint32_t bbbv = 0;
+  std::uint32_t openings = 0;
+  std::uint32_t islands = 0;
+  std::uint32_t largest_opening = 0;
+};
+
+// Boards per block unless a block would get too large for the board size
+constexpr unsigned int kDefaultCorpusBlockBoards = 4096;
+
+// Where a block is in the file
+struct CorpusBlockEntry {
+  std::uint64_t offset;
+  std::uint32_t compressed_size;
+  std::uint32_t board_count;
+};
+
+// Writes a corpus. Boards are appended in order; close() writes the index.
+class CorpusWriter {
+ public:
+  CorpusWriter() = default;
+  ~CorpusWriter();  // Calls close()
+
+  CorpusWriter(const CorpusWriter&) = delete;
+  CorpusWriter& operator=(const CorpusWriter&) = delete;
+
+  // Create or replace the corpus at path, for boards with `settings`. With
+  // `labels` set, every append() must pass labels. Returns false if the file
+  // can't be created or the settings describe no board.
+  bool open(const std::string& path, const GameSettings& settings, bool labels,
+            unsigned int boards_per_block = kDefaultCorpusBlockBoards);
+
+  // Append a generated board with the corpus' settings. Returns false if the
+  // board doesn't fit the corpus or a write failed.
+  bool append(const GameBoard& board, const BoardLabels* labels);
+
+  // Append a board given in the format of GameBoard::load_bombs()
+  bool append(const std::uint8_t* bits, std::uint64_t seed,
+              const BoardLabels* labels);
+
+  // Write the last block, the index and the footer. Returns false if any
+  // write since open() failed; the file is then incomplete.
+  bool close();
+
+  std::uint64_t board_count() const { return board_count_; }
+
+ private:
+  std::FILE* file_ = nullptr;
+  GameSettings settings_ = GameSettings::from_difficulty(Difficulty::Normal);
+  bool labels_ = false;
+  unsigned int boards_per_block_ = 0;
+  std::size_t record_size_ = 0;
+  std::uint64_t board_count_ = 0;
+  // Bytes written so far, i.e. the offset of the next block
+  std::uint64_t offset_ = 0;
+  bool failed_ = false;
+
+  // Records of the block being filled, and its compressed form
+  std::vector<std::uint8_t> block_;
+  unsigned int block_boards_ = 0;
+  std::vector<std::uint8_t> compressed_;
+  std::vector<std::uint8_t> bits_;  // Scratch for append(board)
+  std::vector<CorpusBlockEntry> index_;
+
+  bool write(const void* data, std::size_t size);
+  bool flush_block();
+};
+
+// Reads a corpus. open() reads the header and the index only; boards are
+// decompressed one block at a time. A reader is not thread-safe, but any
+// number of readers may read the same file at once (see
+// read_corpus_parallel()).
+class CorpusReader {
+ public:
+  CorpusReader() = default;
+  ~CorpusReader();
+
+  CorpusReader(const CorpusReader&) = delete;
+  CorpusReader& operator=(const CorpusReader&) = delete;
+
+  // Returns false if the file is missing, not a corpus, or truncated
+  bool open(const std::string& path);
+
+  const GameSettings& settings() const { return settings_; }
+  bool has_labels() const { return labels_; }
+  std::uint64_t board_count() const { return board_count_; }
+  std::size_t block_count() const { return index_.size(); }
+
+  // Decompress a block, which the three functions below then refer to.
+  // Returns false on a read error or a corrupt block.
+  bool load_block(std::size_t block);
+  unsigned int block_board_count() const { return block_boards_; }
+  std::uint64_t block_first_board() const { return block_first_board_; }
+
+  // Reset `board` with board i of the loaded block, changing its settings if
+  // needed. `labels` may be null; it is left alone if the corpus has none.
+  bool load_board(unsigned int i, GameBoard& board, BoardLabels* labels) const;
+
+  // Random access: load the block holding board `index` unless it is
+  // already loaded, then the board
+  bool read_board(std::uint64_t index, GameBoard& board, BoardLabels* labels);
+
+ private:
+  std::FILE* file_ = nullptr;
+  GameSettings settings_ = GameSettings::from_difficulty(Difficulty::Normal);
+  bool labels_ = false;
+  unsigned int boards_per_block_ = 0;
+  std::size_t record_size_ = 0;
+  std::uint64_t board_count_ = 0;
+  std::vector<CorpusBlockEntry> index_;
+
+  // The loaded block
+  std::size_t loaded_block_ = 0;
+  bool block_loaded_ = false;
+  unsigned int block_boards_ = 0;
+  std::uint64_t block_first_board_ = 0;
+  std::vector<std::uint8_t> block_;
+  std::vector<std::uint8_t> compressed_;
+};
+
+// Streams every board of the corpus at `path` into GameBoards on `threads`
+// threads (0 means one per core), without generating any. Each worker owns
+// a reader and a board and takes whole blocks in order from a shared
+// counter. fn(worker, board_index, board, labels) is called concurrently
+// from the workers, worker in [0, threads); labels is null if the corpus has
+// none. Returns false if the corpus can't be read.
+template <typename Fn>
+bool read_corpus_parallel(const std::string& path, unsigned int threads,
+                          Fn&& fn) {
+  std::size_t block_count;
+  {
+    CorpusReader reader;
+    if (!reader.open(path)) {
+      return false;
+    }
+    block_count = reader.block_count();
+  }
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = static_cast<unsigned int>(
+      std::max<std::size_t>(1, std::min<std::size_t>(threads, block_count)));
+
+  std::atomic<std::size_t> next_block{0};
+  std::atomic<bool> ok{true};
+  auto worker = [&](unsigned int worker_index) {
+    CorpusReader reader;
+    if (!reader.open(path)) {
+      ok = false;
+      return;
+    }
+    GameBoard board;
+    board.set_generation_threads(1);
+    BoardLabels labels;
+    BoardLabels* labels_out = reader.has_labels() ? &labels : nullptr;
+    while (ok.load(std::memory_order_relaxed)) {
+      std::size_t block = next_block.fetch_add(1);
+      if (block >= block_count) {
+        break;
+      }
+      if (!reader.load_block(block)) {
+        ok = false;
+        break;
+      }
+      for (unsigned int i = 0; i < reader.block_board_count(); ++i) {
+        if (!reader.load_board(i, board, labels_out)) {
+          ok = false;
+          return;
+        }
+        fn(worker_index, reader.block_first_board() + i,
+           static_cast<const GameBoard&>(board),
+           static_cast<const BoardLabels*>(labels_out));
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 0; t < threads; ++t) {
+    workers.emplace_back(worker, t);
+  }
+  for (std::thread& w : workers) {
+    w.join();
+  }
+  return ok.load();
+}
+
+#endif  // BOARD_CORPUS_H_
@@ -0,0 +1,165 @@
+#include "board_generator.h"
+
+#include <algorithm>
+#include <random>
+
+#include "neighbor_count.h"
+#include "trace.h"
+
+namespace {
+
+// SplitMix64 finalizer. Turns (seed, stream) pairs into well-mixed seeds.
+std::uint64_t mix_seed(std::uint64_t seed, std::uint64_t stream) {
+  std::uint64_t z = seed + (stream + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// Stream 0 splits the bombs between bands; band b uses stream b + 1
+constexpr std::uint64_t kSplitStream = 0;
+
+// Cells of a band that may receive bombs
+std::uint64_t band_free_cells(const BoardLayout& layout, unsigned int band,
+                              const SafeZone* safe_zone) {
+  unsigned int begin_row = generation_band_begin(band);
+  unsigned int end_row = generation_band_end(layout, band);
+  std::uint64_t cells =
+      static_cast<std::uint64_t>(end_row - begin_row) * layout.columns;
+  if (safe_zone) {
+    cells -= safe_zone->cell_count(layout, begin_row, end_row);
+  }
+  return cells;
+}
+
+// Decide how many bombs go into each band. Each band draws from a binomial
+// distribution conditioned on the bombs and free cells left, clamped so the
+// remaining bands can always hold the rest. The last band takes whatever is
+// left, so the total is exact.
+void split_bombs(const BoardLayout& layout, unsigned int bombs,
+                 std::uint64_t seed, const SafeZone* safe_zone,
+                 unsigned int band_count, unsigned int* band_bombs) {
+  std::mt19937_64 rng(mix_seed(seed, kSplitStream));
+  unsigned int remaining_bombs = bombs;
+  std::uint64_t remaining_cells =
+      static_cast<std::uint64_t>(layout.rows) * layout.columns;
+  if (safe_zone) {
+    remaining_cells -= safe_zone->cell_count(layout, 0, layout.rows);
+  }
+
+  for (unsigned int band = 0; band < band_count; ++band) {
+    std::uint64_t band_cells = band_free_cells(layout, band, safe_zone);
+    std::uint64_t other_cells = remaining_cells - band_cells;
+
+    unsigned int count = remaining_bombs;
+    if (band + 1 < band_count) {
+      std::binomial_distribution<unsigned int> dist(
+          remaining_bombs, static_cast<double>(band_cells) / remaining_cells);
+      count = dist(rng);
+    }
+    unsigned int at_least = static_cast<unsigned int>(
+        remaining_bombs > other_cells ? remaining_bombs - other_cells : 0);
+    unsigned int at_most = static_cast<unsigned int>(
+        std::min<std::uint64_t>(remaining_bombs, band_cells));
+    count = std::clamp(count, at_least, at_most);
+
+    band_bombs[band] = count;
+    remaining_bombs -= count;
+    remaining_cells = other_cells;
+  }
+}
+
+void place_band_bombs(const BoardLayout& layout, unsigned int band,
+                      unsigned int bombs, std::uint64_t seed,
+                      std::uint8_t* mask) {
+  const unsigned int first_row = generation_band_begin(band);
+  const unsigned int band_cells =
+      (generation_band_end(layout, band) - first_row) * layout.columns;
+
+  std::mt19937_64 rng(mix_seed(seed, band + 1));
+  std::uniform_int_distribution<unsigned int> dist(0, band_cells - 1);
+
+  unsigned int placed = 0;
+  while (placed < bombs) {
+    unsigned int n = dist(rng);
+    unsigned int index = layout.index(first_row + n / layout.columns,
+                                      n % layout.columns);
+    if (!mask[index]) {
+      mask[index] = 1;
+      placed++;
+    }
+  }
+}
+
+}  // namespace
+
+unsigned int generation_thread_count(const BoardLayout& layout,
+                                     unsigned int requested) {
+  if (static_cast<std::uint64_t>(layout.rows) * layout.columns <
+      kMinParallelGenerationCells) {
+    return 1;
+  }
+  unsigned int threads =
+      requested != 0 ? requested : std::thread::hardware_concurrency();
+  return std::max(1u, std::min(threads, generation_band_count(layout)));
+}
+
+void generate_bombs(const BoardLayout& layout, unsigned int bombs,
+                    std::uint64_t seed, unsigned int threads,
+                    const SafeZone* safe_zone, std::uint8_t* mask,
+                    std::uint8_t* counts) {
+  TRACE_SCOPE("generate_bombs");
+  const unsigned int band_count = generation_band_count(layout);
+
+  // Small boards are a single band; don't allocate for them
+  unsigned int single_band_bombs = bombs;
+  std::vector<unsigned int> band_bombs_storage;
+  unsigned int* band_bombs = &single_band_bombs;
+  if (band_count > 1) {
+    band_bombs_storage.resize(band_count);
+    band_bombs = band_bombs_storage.data();
+    split_bombs(layout, bombs, seed, safe_zone, band_count, band_bombs);
+  }
+
+  std::fill(mask, mask + layout.padded_size(), 0);
+
+  // Reserve the safe zone so placement skips it like an existing bomb
+  auto fill_safe_zone = [&](std::uint8_t value) {
+    for (unsigned int row = safe_zone->first_row();
+         row < safe_zone->end_row(layout); ++row) {
+      for (unsigned int col = safe_zone->first_column();
+           col < safe_zone->end_column(layout); ++col) {
+        mask[layout.index(row, col)] = value;
+      }
+    }
+  };
+  if (safe_zone) {
+    fill_safe_zone(1);
+  }
+
+  // Bands only write their own rows, so they can be placed in parallel
+  for_each_band(band_count, threads, [&](unsigned int band) {
+    TRACE_SCOPE("place_band_bombs");
+    place_band_bombs(layout, band, band_bombs[band], seed, mask);
+  });
+
+  if (safe_zone) {
+    fill_safe_zone(0);
+  }
+
+  // Counts read the rows next to each band too, so they are only computed
+  // once every band has been placed
+  count_bombs(layout, threads, mask, counts);
+}
+
+void count_bombs(const BoardLayout& layout, unsigned int threads,
+                 const std::uint8_t* mask, std::uint8_t* counts) {
+  for_each_band(generation_band_count(layout), threads, [&](unsigned int band) {
+    TRACE_SCOPE("count_neighbors");
+    unsigned int first_row = generation_band_begin(band);
+    unsigned int last_row = generation_band_end(layout, band) - 1;
+    count_neighbors(mask, counts, layout.index(first_row, 0),
+                    layout.index(last_row, layout.columns - 1) + 1,
+                    layout.stride());
+  });
+}
@@ -0,0 +1,116 @@
+#ifndef BOARD_GENERATOR_H_
+#define BOARD_GENERATOR_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "board_layout.h"
+
+// Bomb placement and count computation for a padded board.
+//
+// The board is split into bands of kGenerationBandRows rows. Every band gets
+// its share of the bombs and its own random substream derived from the seed,
+// so bands can be generated independently and in any order. The band height
+// does not depend on the number of threads, which makes the generated board a
+// pure function of (layout, bombs, seed, safe zone).
+
+// Rows per band
+constexpr unsigned int kGenerationBandRows = 64;
+
+// Boards smaller than this are always generated on the calling thread;
+// starting threads costs more than it saves
+constexpr unsigned int kMinParallelGenerationCells = 1u << 20;
+
+// Number of bands of a board
+inline unsigned int generation_band_count(const BoardLayout& layout) {
+  return (layout.rows + kGenerationBandRows - 1) / kGenerationBandRows;
+}
+
+// Rows [generation_band_begin(band), generation_band_end(layout, band)) make
+// up a band
+inline unsigned int generation_band_begin(unsigned int band) {
+  return band * kGenerationBandRows;
+}
+inline unsigned int generation_band_end(const BoardLayout& layout,
+                                        unsigned int band) {
+  unsigned int end = (band + 1) * kGenerationBandRows;
+  return end < layout.rows ? end : layout.rows;
+}
+
+// Number of threads to use for a board. `requested` of 0 means one per core.
+unsigned int generation_thread_count(const BoardLayout& layout,
+                                     unsigned int requested);
+
+// Call fn(band) for every band, spread over `threads` threads. Bands are
+// assigned round-robin; fn must only touch its own band's rows.
+template <typename Fn>
+void for_each_band(unsigned int band_count, unsigned int threads, Fn&& fn) {
+  if (threads <= 1 || band_count <= 1) {
+    for (unsigned int band = 0; band < band_count; ++band) {
+      fn(band);
+    }
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (unsigned int t = 0; t < threads; ++t) {
+    workers.emplace_back([&fn, t, threads, band_count]() {
+      for (unsigned int band = t; band < band_count; band += threads) {
+        fn(band);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+// Cells kept free of bombs: the square of `radius` cells around (row,
+// column), clipped to the board. Radius 1 is a first click and its neighbors.
+struct SafeZone {
+  unsigned int row;
+  unsigned int column;
+  unsigned int radius;
+
+  unsigned int first_row() const { return row > radius ? row - radius : 0; }
+  unsigned int end_row(const BoardLayout& layout) const {
+    return std::min(row + radius + 1, layout.rows);
+  }
+  unsigned int first_column() const {
+    return column > radius ? column - radius : 0;
+  }
+  unsigned int end_column(const BoardLayout& layout) const {
+    return std::min(column + radius + 1, layout.columns);
+  }
+
+  // Cells of the zone within rows [from_row, to_row)
+  unsigned int cell_count(const BoardLayout& layout, unsigned int from_row,
+                          unsigned int to_row) const {
+    unsigned int begin = std::max(from_row, first_row());
+    unsigned int end = std::min(to_row, end_row(layout));
+    if (begin >= end) {
+      return 0;
+    }
+    return (end - begin) * (end_column(layout) - first_column());
+  }
+};
+
+// Fill `mask` (padded_size() bytes) with exactly `bombs` bombs and write the
+// bomb count of every in-board cell to `counts`. Sentinel bytes of the mask
+// are left 0. If `safe_zone` is not null its cells get no bombs; the caller
+// must leave room for the bombs outside it.
+void generate_bombs(const BoardLayout& layout, unsigned int bombs,
+                    std::uint64_t seed, unsigned int threads,
+                    const SafeZone* safe_zone, std::uint8_t* mask,
+                    std::uint8_t* counts);
+
+// Write the bomb count of every in-board cell of `mask` to `counts`, band by
+// band. The last step of generate_bombs(), also used for layouts that were
+// loaded rather than generated.
+void count_bombs(const BoardLayout& layout, unsigned int threads,
+                 const std::uint8_t* mask, std::uint8_t* counts);
+
+#endif  // BOARD_GENERATOR_H_
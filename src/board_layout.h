@@ -0,0 +1,226 @@
+#ifndef BOARD_LAYOUT_H_
+#define BOARD_LAYOUT_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Memory layout of a board's cells.
+//
+// Cells are stored row-major with a one-cell sentinel ring around the board,
+// i.e. as a (rows + 2) x (columns + 2) grid. Every neighbor of an in-board
+// cell is therefore a valid index at a fixed offset, and neighbor loops need
+// no bounds checks. Sentinel cells are kept open and bomb-free so the game
+// logic naturally skips them (see clear_cells in board_storage.h).
+struct BoardLayout {
+  unsigned int rows;
+  unsigned int columns;
+
+  // Distance between vertically adjacent cells
+  constexpr unsigned int stride() const { return columns + 2; }
+
+  // Number of cells including the sentinel ring
+  constexpr unsigned int padded_size() const { return (rows + 2) * stride(); }
+
+  // Whether every padded index of a rows x columns board fits in 32 bits
+  static constexpr bool fits(unsigned int rows, unsigned int columns) {
+    return (std::uint64_t{rows} + 2) * (std::uint64_t{columns} + 2) <=
+           UINT32_MAX;
+  }
+
+  // Index of the in-board cell at (row, column)
+  constexpr unsigned int index(unsigned int row, unsigned int column) const {
+    return (row + 1) * stride() + column + 1;
+  }
+
+  // Index of the n-th in-board cell in row-major order
+  constexpr unsigned int index(unsigned int n) const {
+    return index(n / columns, n % columns);
+  }
+
+  // Padded row of an index (0 and rows + 1 are the sentinel rows)
+  constexpr unsigned int padded_row(unsigned int index) const {
+    return index / stride();
+  }
+
+  // [begin_index(), end_index()) is the smallest contiguous range holding all
+  // in-board cells. The sentinel columns of inner rows are included.
+  constexpr unsigned int begin_index() const { return index(0, 0); }
+  constexpr unsigned int end_index() const {
+    return index(rows - 1, columns - 1) + 1;
+  }
+
+  // Offsets from a cell to its 8 neighbors
+  constexpr std::array<int, 8> neighbor_offsets() const {
+    const int s = static_cast<int>(stride());
+    return {-s - 1, -s, -s + 1, -1, 1, s - 1, s, s + 1};
+  }
+
+  // Call fn(neighbor_index) for the 8 neighbors of an in-board cell. Some of
+  // them may be sentinels.
+  template <typename Fn>
+  void for_each_neighbor(unsigned int index, Fn&& fn) const {
+    for (int offset : neighbor_offsets()) {
+      fn(static_cast<unsigned int>(static_cast<int>(index) + offset));
+    }
+  }
+
+  // Call fn(index) for every in-board cell in row-major order
+  template <typename Fn>
+  void for_each_cell(Fn&& fn) const {
+    for (unsigned int row = 0; row < rows; ++row) {
+      unsigned int row_start = index(row, 0);
+      for (unsigned int col = 0; col < columns; ++col) {
+        fn(row_start + col);
+      }
+    }
+  }
+
+  // Call fn(index, row, column) for every in-board cell of rows
+  // [begin_row, end_row), in memory order
+  template <typename Fn>
+  void for_each_cell_in_rows(unsigned int begin_row, unsigned int end_row,
+                             Fn&& fn) const {
+    for (unsigned int row = begin_row; row < end_row; ++row) {
+      unsigned int row_start = index(row, 0);
+      for (unsigned int col = 0; col < columns; ++col) {
+        fn(row_start + col, row, col);
+      }
+    }
+  }
+};
+
+// Tiled layout of the same padded grid, for very wide boards.
+//
+// The padded grid is cut into 8 x 8 tiles, stored one after another in
+// row-major tile order, with the cells of a tile row-major inside it. All
+// eight neighbors of a cell are then at most one tile row away, instead of a
+// whole board row, so flood fills on boards thousands of columns wide stay
+// within a few cache lines and pages. The price is that neighbor offsets
+// depend on the cell's position in its tile, and row-major scans jump between
+// tiles every 8 cells.
+//
+// An index is the sum of a column part and a row part, so index(row, column)
+// needs no division and for_each_neighbor() works from the index alone.
+// Tiles along the right and bottom edges are padded; those cells are never
+// in-board and are kept as sentinels.
+struct TiledBoardLayout {
+  unsigned int rows;
+  unsigned int columns;
+
+  // Tile edge in cells, a power of two
+  static constexpr unsigned int kTileShift = 3;
+  static constexpr unsigned int kTileSize = 1u << kTileShift;
+  static constexpr unsigned int kTileMask = kTileSize - 1;
+  static constexpr unsigned int kTileCells = kTileSize * kTileSize;
+
+  // Tiles across the padded grid
+  constexpr unsigned int tile_columns() const {
+    return (columns + 2 + kTileMask) >> kTileShift;
+  }
+  constexpr unsigned int tile_rows() const {
+    return (rows + 2 + kTileMask) >> kTileShift;
+  }
+
+  // Distance between vertically adjacent tiles
+  constexpr unsigned int tile_row_stride() const {
+    return tile_columns() * kTileCells;
+  }
+
+  // Number of cells including the sentinel ring and the tile padding
+  constexpr unsigned int padded_size() const {
+    return tile_rows() * tile_row_stride();
+  }
+
+  // Whether every padded index fits in 32 bits. The tile padding can push a
+  // board that fits a BoardLayout past the limit.
+  static constexpr bool fits(unsigned int rows, unsigned int columns) {
+    return ((std::uint64_t{rows} + 2 + kTileMask) >> kTileShift) *
+               ((std::uint64_t{columns} + 2 + kTileMask) >> kTileShift) *
+               kTileCells <=
+           UINT32_MAX;
+  }
+
+  // Index of the cell at padded coordinates (sentinels at 0 and rows + 1)
+  constexpr unsigned int padded_index(unsigned int padded_row,
+                                      unsigned int padded_column) const {
+    return (padded_row >> kTileShift) * tile_row_stride() +
+           ((padded_row & kTileMask) << kTileShift) +
+           (padded_column >> kTileShift) * kTileCells +
+           (padded_column & kTileMask);
+  }
+
+  // Index of the in-board cell at (row, column)
+  constexpr unsigned int index(unsigned int row, unsigned int column) const {
+    return padded_index(row + 1, column + 1);
+  }
+
+  // Index of the n-th in-board cell in row-major order
+  constexpr unsigned int index(unsigned int n) const {
+    return index(n / columns, n % columns);
+  }
+
+  // Padded row of an index (0 and rows + 1 are the sentinel rows)
+  constexpr unsigned int padded_row(unsigned int index) const {
+    return (index / tile_row_stride()) << kTileShift |
+           ((index >> kTileShift) & kTileMask);
+  }
+
+  // Call fn(neighbor_index) for the 8 neighbors of an in-board cell. Some of
+  // them may be sentinels.
+  template <typename Fn>
+  void for_each_neighbor(unsigned int index, Fn&& fn) const {
+    // Step to the next cell in the tile, or across into the next tile
+    const unsigned int x = index & kTileMask;
+    const unsigned int y = (index >> kTileShift) & kTileMask;
+    const int across = static_cast<int>(kTileCells - kTileMask);
+    const int down = static_cast<int>(tile_row_stride() -
+                                      kTileMask * kTileSize);
+    const int left = x != 0 ? -1 : -across;
+    const int right = x != kTileMask ? 1 : across;
+    const int up = y != 0 ? -static_cast<int>(kTileSize) : -down;
+    const int below = y != kTileMask ? static_cast<int>(kTileSize) : down;
+
+    const int i = static_cast<int>(index);
+    for (int offset : {up + left, up, up + right, left, right, below + left,
+                       below, below + right}) {
+      fn(static_cast<unsigned int>(i + offset));
+    }
+  }
+
+  // Call fn(index) for every in-board cell in row-major order
+  template <typename Fn>
+  void for_each_cell(Fn&& fn) const {
+    for (unsigned int row = 0; row < rows; ++row) {
+      for (unsigned int col = 0; col < columns; ++col) {
+        fn(index(row, col));
+      }
+    }
+  }
+
+  // Call fn(index, row, column) for every in-board cell of rows
+  // [begin_row, end_row), in memory order: tile by tile along each tile row
+  template <typename Fn>
+  void for_each_cell_in_rows(unsigned int begin_row, unsigned int end_row,
+                             Fn&& fn) const {
+    unsigned int row = begin_row;
+    while (row < end_row) {
+      // Rows of the range in the tile row holding `row`
+      unsigned int tile_end = (((row + 1) >> kTileShift) + 1) << kTileShift;
+      unsigned int chunk_end = std::min(end_row, tile_end - 1);
+      for (unsigned int tile = 0; tile < tile_columns(); ++tile) {
+        unsigned int first_col = tile == 0 ? 0 : tile * kTileSize - 1;
+        unsigned int last_col = std::min(columns, (tile + 1) * kTileSize - 1);
+        for (unsigned int r = row; r < chunk_end; ++r) {
+          unsigned int tile_row_start = index(r, first_col);
+          for (unsigned int col = first_col; col < last_col; ++col) {
+            fn(tile_row_start + (col - first_col), r, col);
+          }
+        }
+      }
+      row = chunk_end;
+    }
+  }
+};
+
+#endif  // BOARD_LAYOUT_H_
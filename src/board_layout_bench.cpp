@@ -0,0 +1,221 @@
+// Compares the row-major and the tiled cell layout (board_layout.h) on a
+// large board.
+//
+// Usage:
+//   Minesweeper_LayoutBench [--size ROWSxCOLUMNS] [--bombs N] [--seed S]
+//                           [--repeat N] [--threads N]
+//
+// Defaults to 1024 x 16384 cells with 1% bombs, so one click floods most of
+// the board. Both boards get the same bombs from the seed. For each layout,
+// prints the best of --repeat runs of:
+//   generate  reset() and generate(): bombs, counts and the copy into cells
+//   flood     open_cell() on the first empty cell
+//   scan      row-major pass over get_cell(), encoding every cell to a byte
+//             like the renderer's board texture
+// Generation uses --threads threads (default 1, 0 for one per core).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "game_board.h"
+
+namespace {
+
+struct Options {
+  unsigned int rows = 1024;
+  unsigned int columns = 16384;
+  unsigned int bombs = 0;  // 0 means 1% of the cells
+  std::uint64_t seed = 1;
+  unsigned int repeat = 3;
+  unsigned int threads = 1;
+};
+
+// Best time of each benchmark, plus results to check the layouts agree on
+struct LayoutResult {
+  double generate_ms = std::numeric_limits<double>::max();
+  double flood_ms = std::numeric_limits<double>::max();
+  double scan_ms = std::numeric_limits<double>::max();
+  unsigned int opened = 0;
+  std::uint64_t checksum = 0;
+};
+
+void print_usage() {
+  std::cerr << "Usage: Minesweeper_LayoutBench [--size ROWSxCOLUMNS] "
+               "[--bombs N] [--seed S]\n"
+               "                               [--repeat N] [--threads N]"
+            << std::endl;
+}
+
+// Digits only, up to UINT_MAX (as in board_metrics_cli.cpp), so "-5" is an
+// error rather than a huge size
+bool parse_unsigned(const std::string& text, unsigned int& value) {
+  if (text.empty() ||
+      text.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  unsigned long long parsed = std::stoull(text);
+  if (parsed > std::numeric_limits<unsigned int>::max()) {
+    return false;
+  }
+  value = static_cast<unsigned int>(parsed);
+  return true;
+}
+
+// ROWSxCOLUMNS, nothing before or after
+bool parse_size(const std::string& text, unsigned int& rows,
+                unsigned int& columns) {
+  std::size_t x = text.find('x');
+  return x != std::string::npos && parse_unsigned(text.substr(0, x), rows) &&
+         parse_unsigned(text.substr(x + 1), columns);
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      bool has_value = i + 1 < argc;
+      if (arg == "--size" && has_value) {
+        if (!parse_size(argv[++i], options.rows, options.columns)) {
+          return false;
+        }
+      } else if (arg == "--bombs" && has_value) {
+        if (!parse_unsigned(argv[++i], options.bombs)) {
+          return false;
+        }
+      } else if (arg == "--seed" && has_value) {
+        options.seed = std::stoull(argv[++i]);
+      } else if (arg == "--repeat" && has_value) {
+        options.repeat = static_cast<unsigned int>(std::stoul(argv[++i]));
+      } else if (arg == "--threads" && has_value) {
+        options.threads = static_cast<unsigned int>(std::stoul(argv[++i]));
+      } else {
+        return false;
+      }
+    }
+  } catch (const std::exception&) {
+    return false;  // Not a number
+  }
+
+  // Both layouts must hold the board; tiles pad it the most
+  if (options.repeat == 0 ||
+      !GameSettings::from_dimensions(options.rows, options.columns, 0)
+           .is_valid() ||
+      !TiledBoardLayout::fits(options.rows, options.columns)) {
+    return false;
+  }
+  const unsigned int cells = options.rows * options.columns;
+  if (options.bombs == 0) {
+    options.bombs = std::max(1u, cells / 100);
+  }
+  return options.bombs < cells;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Same encoding as the renderer's board texture
+std::uint8_t cell_code(const Cell& cell) {
+  if (!cell.is_open()) {
+    return cell.has_flag() ? 10 : 9;
+  }
+  return cell.has_bomb() ? 11
+                         : static_cast<std::uint8_t>(cell.get_bomb_count());
+}
+
+// Returns false if the layout can't hold a board of this size
+template <typename Board>
+bool run(const Options& options, LayoutResult& result) {
+  const unsigned int rows = options.rows;
+  const unsigned int columns = options.columns;
+  Board board;
+  board.set_generation_threads(options.threads);
+  if (!board.change_settings(
+          GameSettings::from_dimensions(rows, columns, options.bombs))) {
+    return false;
+  }
+  std::vector<std::uint8_t> plane(std::size_t{rows} * columns);
+
+  for (unsigned int i = 0; i < options.repeat; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    board.reset(options.seed);
+    board.generate();
+    result.generate_ms = std::min(result.generate_ms, elapsed_ms(start));
+
+    // Click the first empty cell, as a player would to open an area
+    unsigned int click = 0;
+    while (click < rows * columns - 1 &&
+           (board.get_cell(click / columns, click % columns).has_bomb() ||
+            board.get_cell(click / columns, click % columns).get_bomb_count() !=
+                0)) {
+      ++click;
+    }
+    start = std::chrono::steady_clock::now();
+    board.open_cell(click / columns, click % columns);
+    result.flood_ms = std::min(result.flood_ms, elapsed_ms(start));
+    result.opened = board.get_opened_count();
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned int row = 0; row < rows; ++row) {
+      std::uint8_t* out = plane.data() + std::size_t{row} * columns;
+      for (unsigned int col = 0; col < columns; ++col) {
+        out[col] = cell_code(board.get_cell(row, col));
+      }
+    }
+    result.scan_ms = std::min(result.scan_ms, elapsed_ms(start));
+  }
+
+  // FNV-1a of the last scan, to check both layouts hold the same board
+  result.checksum = 14695981039346656037ull;
+  for (std::uint8_t code : plane) {
+    result.checksum = (result.checksum ^ code) * 1099511628211ull;
+  }
+  return true;
+}
+
+void print_result(const char* name, const LayoutResult& result) {
+  std::printf("%-11s %10.2f %10.2f %10.2f\n", name, result.generate_ms,
+              result.flood_ms, result.scan_ms);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    print_usage();
+    return 1;
+  }
+
+  // One board at a time, so both get the same memory conditions
+  LayoutResult row_major;
+  LayoutResult tiled;
+  if (!run<GameBoard>(options, row_major) ||
+      !run<TiledGameBoard>(options, tiled)) {
+    std::cerr << "Failed to set up the boards" << std::endl;
+    return 1;
+  }
+
+  std::printf("board:  %ux%u, %u bombs, best of %u\n", options.rows,
+              options.columns, options.bombs, options.repeat);
+  std::printf("%-11s %10s %10s %10s\n", "layout (ms)", "generate", "flood",
+              "scan");
+  print_result("row-major", row_major);
+  print_result("tiled", tiled);
+  std::printf("flood:  %u cells opened\n", row_major.opened);
+
+  if (row_major.opened != tiled.opened ||
+      row_major.checksum != tiled.checksum) {
+    std::cerr << "The layouts produced different boards" << std::endl;
+    return 1;
+  }
+  return 0;
+}
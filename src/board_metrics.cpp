@@ -0,0 +1,128 @@
+#include "board_metrics.h"
+
+#include <algorithm>
+
+namespace {
+
+// Marks a numbered cell that borders no opening, once it has been classified
+constexpr std::uint8_t kIsolated = 11;
+
+}  // namespace
+
+void BoardAnalyzer::begin(unsigned int rows, unsigned int columns) {
+  layout_ = BoardLayout{rows, columns};
+  // assign() keeps the capacity, so same-sized boards don't reallocate
+  plane_.assign(layout_.padded_size(), kOutside);
+  parent_.resize(layout_.padded_size());
+  opening_size_.resize(layout_.padded_size());
+}
+
+unsigned int BoardAnalyzer::find(unsigned int index) {
+  // Path halving
+  while (parent_[index] != index) {
+    parent_[index] = parent_[parent_[index]];
+    index = parent_[index];
+  }
+  return index;
+}
+
+void BoardAnalyzer::unite(unsigned int a, unsigned int b) {
+  unsigned int root_a = find(a);
+  unsigned int root_b = find(b);
+  // The smaller index becomes the root
+  if (root_a < root_b) {
+    parent_[root_b] = root_a;
+  } else if (root_b < root_a) {
+    parent_[root_a] = root_b;
+  }
+}
+
+const BoardMetrics& BoardAnalyzer::compute() {
+  const auto offsets = layout_.neighbor_offsets();
+  // The first 4 offsets point to neighbors that come earlier in row-major
+  // order (up-left, up, up-right, left), so each pair is joined exactly once
+  const int* earlier = offsets.data();
+  const int earlier_count = 4;
+
+  // Reset field by field; assigning a fresh BoardMetrics would drop the
+  // capacity of opening_sizes
+  metrics_.bbbv = 0;
+  metrics_.openings = 0;
+  metrics_.islands = 0;
+  metrics_.isolated_numbers = 0;
+  metrics_.largest_opening = 0;
+  metrics_.opening_sizes.clear();
+
+  // Pass 1: build the openings from zero cells, and the islands from numbered
+  // cells that have no zero neighbor
+  layout_.for_each_cell([&](unsigned int index) {
+    parent_[index] = index;
+    opening_size_[index] = 0;
+
+    std::uint8_t value = plane_[index];
+    if (value == 0) {
+      for (int k = 0; k < earlier_count; ++k) {
+        unsigned int neighbor = index + earlier[k];
+        if (plane_[neighbor] == 0) {
+          unite(index, neighbor);
+        }
+      }
+    } else if (value != kBomb) {
+      bool borders_opening = false;
+      for (int offset : offsets) {
+        borders_opening |= plane_[index + offset] == 0;
+      }
+      if (!borders_opening) {
+        plane_[index] = kIsolated;
+        metrics_.isolated_numbers++;
+        for (int k = 0; k < earlier_count; ++k) {
+          unsigned int neighbor = index + earlier[k];
+          if (plane_[neighbor] == kIsolated) {
+            unite(index, neighbor);
+          }
+        }
+      }
+    }
+  });
+
+  // Pass 2: count the components and the cells each opening reveals. The
+  // root indices of the openings are collected in opening_sizes for now.
+  layout_.for_each_cell([&](unsigned int index) {
+    std::uint8_t value = plane_[index];
+    if (value == 0) {
+      unsigned int root = find(index);
+      if (root == index) {
+        metrics_.opening_sizes.push_back(root);
+      }
+      opening_size_[root]++;
+    } else if (value == kIsolated) {
+      if (find(index) == index) {
+        metrics_.islands++;
+      }
+    } else if (value != kBomb) {
+      // A numbered cell is revealed by every opening it borders
+      unsigned int roots[8];
+      int root_count = 0;
+      for (int offset : offsets) {
+        unsigned int neighbor = index + offset;
+        if (plane_[neighbor] != 0) {
+          continue;
+        }
+        unsigned int root = find(neighbor);
+        if (std::find(roots, roots + root_count, root) == roots + root_count) {
+          roots[root_count++] = root;
+          opening_size_[root]++;
+        }
+      }
+    }
+  });
+
+  for (unsigned int& size : metrics_.opening_sizes) {
+    size = opening_size_[size];
+    metrics_.largest_opening = std::max(metrics_.largest_opening, size);
+  }
+  metrics_.openings =
+      static_cast<unsigned int>(metrics_.opening_sizes.size());
+  metrics_.bbbv = metrics_.openings + metrics_.isolated_numbers;
+  return metrics_;
+}
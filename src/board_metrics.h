@@ -0,0 +1,68 @@
+#ifndef BOARD_METRICS_H_
+#define BOARD_METRICS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "board_layout.h"
+
+// Difficulty metrics of a generated board.
+//
+//   opening   8-connected region of cells with no adjacent bombs. One click
+//             opens the region and the numbered cells around it.
+//   island    8-connected region of numbered cells that border no opening.
+//             Every cell of an island needs its own click.
+//   3BV       minimum number of left clicks to clear the board: one per
+//             opening plus one per numbered cell outside of every opening.
+struct BoardMetrics {
+  unsigned int bbbv = 0;
+  unsigned int openings = 0;
+  unsigned int islands = 0;
+  // Numbered cells that border no opening (= bbbv - openings)
+  unsigned int isolated_numbers = 0;
+  unsigned int largest_opening = 0;
+  // Cells opened by each opening's click, including its numbered border
+  std::vector<unsigned int> opening_sizes;
+};
+
+// Computes BoardMetrics with union-find over the cells. Buffers are kept
+// between calls, so analyzing many boards of the same size doesn't allocate.
+class BoardAnalyzer {
+ public:
+  // Analyze any board type with get_rows/get_columns/get_cell
+  template <typename Board>
+  const BoardMetrics& analyze(const Board& board) {
+    begin(board.get_rows(), board.get_columns());
+    layout_.for_each_cell([&](unsigned int index) {
+      unsigned int n = index - layout_.begin_index();
+      unsigned int row = n / layout_.stride();
+      unsigned int col = n % layout_.stride();
+      const auto& cell = board.get_cell(row, col);
+      plane_[index] = cell.has_bomb()
+                          ? kBomb
+                          : static_cast<std::uint8_t>(cell.get_bomb_count());
+    });
+    return compute();
+  }
+
+ private:
+  // Values of plane_ besides counts 0-8
+  static constexpr std::uint8_t kBomb = 9;
+  static constexpr std::uint8_t kOutside = 10;
+
+  BoardLayout layout_{0, 0};
+  // Per padded cell: bomb count, kBomb or kOutside for the sentinel ring
+  std::vector<std::uint8_t> plane_;
+  // Union-find parents, indexed like plane_
+  std::vector<unsigned int> parent_;
+  // Cells opened by the opening rooted at each index
+  std::vector<unsigned int> opening_size_;
+  BoardMetrics metrics_;
+
+  void begin(unsigned int rows, unsigned int columns);
+  const BoardMetrics& compute();
+  unsigned int find(unsigned int index);
+  void unite(unsigned int a, unsigned int b);
+};
+
+#endif  // BOARD_METRICS_H_
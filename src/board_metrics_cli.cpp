@@ -0,0 +1,311 @@
+// Scores many seeded boards with BoardAnalyzer.
+//
+// Usage:
+//   Minesweeper_Metrics [--difficulty easy|normal|hard]
+//                       [--size ROWSxCOLUMNS --bombs N]
+//                       [--boards N] [--seed S] [--threads N] [--csv]
+//                       [--write-corpus PATH | --read-corpus PATH]
+//
+// Board i is generated from seed S + i with no first click, so any board can
+// be reproduced with GameBoard::reset(S + i) followed by generate(). Prints a
+// summary, or one CSV line per board with --csv.
+//
+// --write-corpus also stores the boards and their scores as a board corpus
+// (board_corpus.h). --read-corpus scores the boards of a corpus instead of
+// generating any, and checks them against the stored scores.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "board_corpus.h"
+#include "board_metrics.h"
+#include "game_board.h"
+
+namespace {
+
+struct Options {
+  GameSettings settings = GameSettings::from_difficulty(Difficulty::Normal);
+  std::uint64_t boards = 100000;
+  std::uint64_t seed = 1;
+  unsigned int threads = 0;
+  bool csv = false;
+  std::string write_corpus;
+  std::string read_corpus;
+};
+
+// Per-board result, kept compact so millions of boards fit in memory
+struct BoardScore {
+  std::uint64_t seed;
+  unsigned int bbbv;
+  unsigned int openings;
+  unsigned int islands;
+  unsigned int largest_opening;
+};
+
+void print_usage() {
+  std::cerr << "Usage: Minesweeper_Metrics [--difficulty easy|normal|hard]\n"
+               "                           [--size ROWSxCOLUMNS --bombs N]\n"
+               "                           [--boards N] [--seed S] "
+               "[--threads N] [--csv]\n"
+               "                           [--write-corpus PATH | "
+               "--read-corpus PATH]"
+            << std::endl;
+}
+
+// A decimal number of at most UINT_MAX. std::stoul alone accepts a leading
+// '-' and wraps it to a huge value.
+bool parse_unsigned(const std::string& text, unsigned int& value) {
+  if (text.empty() ||
+      text.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  unsigned long long parsed = std::stoull(text);
+  if (parsed > std::numeric_limits<unsigned int>::max()) {
+    return false;
+  }
+  value = static_cast<unsigned int>(parsed);
+  return true;
+}
+
+// ROWSxCOLUMNS
+bool parse_size(const std::string& text, unsigned int& rows,
+                unsigned int& columns) {
+  std::size_t x = text.find('x');
+  return x != std::string::npos && parse_unsigned(text.substr(0, x), rows) &&
+         parse_unsigned(text.substr(x + 1), columns);
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+  unsigned int rows = 0;
+  unsigned int columns = 0;
+  unsigned int bombs = 0;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      bool has_value = i + 1 < argc;
+      if (arg == "--csv") {
+        options.csv = true;
+      } else if (arg == "--difficulty" && has_value) {
+        std::string name = argv[++i];
+        if (name == "easy") {
+          options.settings = GameSettings::from_difficulty(Difficulty::Easy);
+        } else if (name == "normal") {
+          options.settings = GameSettings::from_difficulty(Difficulty::Normal);
+        } else if (name == "hard") {
+          options.settings = GameSettings::from_difficulty(Difficulty::Hard);
+        } else {
+          return false;
+        }
+      } else if (arg == "--size" && has_value) {
+        if (!parse_size(argv[++i], rows, columns)) {
+          return false;
+        }
+      } else if (arg == "--bombs" && has_value) {
+        if (!parse_unsigned(argv[++i], bombs)) {
+          return false;
+        }
+      } else if (arg == "--boards" && has_value) {
+        options.boards = std::stoull(argv[++i]);
+      } else if (arg == "--seed" && has_value) {
+        options.seed = std::stoull(argv[++i]);
+      } else if (arg == "--threads" && has_value) {
+        options.threads = static_cast<unsigned int>(std::stoul(argv[++i]));
+      } else if (arg == "--write-corpus" && has_value) {
+        options.write_corpus = argv[++i];
+      } else if (arg == "--read-corpus" && has_value) {
+        options.read_corpus = argv[++i];
+      } else {
+        return false;
+      }
+    }
+  } catch (const std::exception&) {
+    return false;  // Not a number
+  }
+
+  if (rows != 0 || columns != 0 || bombs != 0) {
+    options.settings = GameSettings::from_dimensions(rows, columns, bombs);
+    if (!options.settings.is_valid()) {
+      return false;
+    }
+  }
+  return options.write_corpus.empty() || options.read_corpus.empty();
+}
+
+BoardScore score_of(const GameBoard& board, const BoardMetrics& metrics) {
+  return BoardScore{board.get_seed(), metrics.bbbv, metrics.openings,
+                    metrics.islands, metrics.largest_opening};
+}
+
+// Generate and score options.boards boards
+void score_generated(const Options& options, unsigned int threads,
+                     std::vector<BoardScore>& scores,
+                     std::vector<std::uint8_t>& bombs) {
+  scores.resize(options.boards);
+  // Bomb bits of every board, only kept to write the corpus
+  const std::size_t bits_size = (options.settings.cell_count() + 7) / 8;
+  if (!options.write_corpus.empty()) {
+    bombs.resize(options.boards * bits_size);
+  }
+
+  // Each worker owns a board and an analyzer, and scores every
+  // threads-th board. Boards are generated single-threaded; the parallelism
+  // is across boards.
+  auto worker = [&](unsigned int worker_index) {
+    GameBoard board;
+    board.set_generation_threads(1);
+    board.change_settings(options.settings);
+    BoardAnalyzer analyzer;
+
+    for (std::uint64_t i = worker_index; i < options.boards; i += threads) {
+      board.reset(options.seed + i);
+      board.generate();
+      scores[i] = score_of(board, analyzer.analyze(board));
+      if (!bombs.empty()) {
+        board.store_bombs(bombs.data() + i * bits_size);
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 0; t < threads; ++t) {
+    workers.emplace_back(worker, t);
+  }
+  for (std::thread& w : workers) {
+    w.join();
+  }
+}
+
+bool write_corpus(const Options& options,
+                  const std::vector<BoardScore>& scores,
+                  const std::vector<std::uint8_t>& bombs) {
+  CorpusWriter writer;
+  if (!writer.open(options.write_corpus, options.settings, true)) {
+    return false;
+  }
+  const std::size_t bits_size = (options.settings.cell_count() + 7) / 8;
+  for (std::size_t i = 0; i < scores.size(); ++i) {
+    const BoardScore& score = scores[i];
+    BoardLabels labels{score.bbbv, score.openings, score.islands,
+                       score.largest_opening};
+    if (!writer.append(bombs.data() + i * bits_size, score.seed, &labels)) {
+      break;  // close() reports the error
+    }
+  }
+  return writer.close();
+}
+
+// Score the boards of a corpus, streamed on every thread. Counts boards
+// whose stored labels differ from the scores.
+bool score_corpus(Options& options, unsigned int threads,
+                  std::vector<BoardScore>& scores,
+                  std::uint64_t& label_mismatches) {
+  {
+    CorpusReader reader;
+    if (!reader.open(options.read_corpus)) {
+      return false;
+    }
+    options.settings = reader.settings();
+    scores.resize(reader.board_count());
+  }
+
+  std::vector<BoardAnalyzer> analyzers(threads);
+  std::atomic<std::uint64_t> mismatches{0};
+  bool ok = read_corpus_parallel(
+      options.read_corpus, threads,
+      [&](unsigned int worker, std::uint64_t index, const GameBoard& board,
+          const BoardLabels* labels) {
+        const BoardMetrics& metrics = analyzers[worker].analyze(board);
+        scores[index] = score_of(board, metrics);
+        if (labels && (labels->bbbv != metrics.bbbv ||
+                       labels->openings != metrics.openings ||
+                       labels->islands != metrics.islands ||
+                       labels->largest_opening != metrics.largest_opening)) {
+          mismatches.fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+  label_mismatches = mismatches.load();
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    print_usage();
+    return 1;
+  }
+
+  unsigned int threads = options.threads != 0
+                             ? options.threads
+                             : std::max(1u, std::thread::hardware_concurrency());
+  std::vector<BoardScore> scores;
+  std::uint64_t label_mismatches = 0;
+  if (!options.read_corpus.empty()) {
+    if (!score_corpus(options, threads, scores, label_mismatches)) {
+      return 1;
+    }
+  } else {
+    std::vector<std::uint8_t> bombs;
+    score_generated(options, threads, scores, bombs);
+    if (!options.write_corpus.empty() &&
+        !write_corpus(options, scores, bombs)) {
+      return 1;
+    }
+  }
+
+  if (options.csv) {
+    std::printf("seed,3bv,openings,islands,largest_opening\n");
+    for (const BoardScore& score : scores) {
+      std::printf("%llu,%u,%u,%u,%u\n",
+                  static_cast<unsigned long long>(score.seed),
+                  score.bbbv, score.openings, score.islands,
+                  score.largest_opening);
+    }
+    return 0;
+  }
+
+  if (scores.empty()) {
+    return 0;
+  }
+
+  // Summary: mean, min, max, and the 3BV distribution's quartiles
+  std::vector<unsigned int> bbbv(scores.size());
+  double openings_sum = 0.0;
+  double islands_sum = 0.0;
+  for (std::size_t i = 0; i < scores.size(); ++i) {
+    bbbv[i] = scores[i].bbbv;
+    openings_sum += scores[i].openings;
+    islands_sum += scores[i].islands;
+  }
+  std::sort(bbbv.begin(), bbbv.end());
+  double bbbv_sum = 0.0;
+  for (unsigned int value : bbbv) {
+    bbbv_sum += value;
+  }
+  const double count = static_cast<double>(scores.size());
+
+  std::printf("boards:   %llu (%ux%u, %u bombs)\n",
+              static_cast<unsigned long long>(scores.size()),
+              options.settings.rows, options.settings.columns,
+              options.settings.bombs);
+  std::printf("3BV:      mean %.2f  min %u  p25 %u  p50 %u  p75 %u  max %u\n",
+              bbbv_sum / count, bbbv.front(), bbbv[bbbv.size() / 4],
+              bbbv[bbbv.size() / 2], bbbv[bbbv.size() * 3 / 4], bbbv.back());
+  std::printf("openings: mean %.2f\n", openings_sum / count);
+  std::printf("islands:  mean %.2f\n", islands_sum / count);
+  if (!options.read_corpus.empty()) {
+    std::printf("labels:   %llu mismatched\n",
+                static_cast<unsigned long long>(label_mismatches));
+  }
+  return 0;
+}
@@ -0,0 +1,210 @@
+#ifndef BOARD_STORAGE_H_
+#define BOARD_STORAGE_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "board_layout.h"
+#include "cell.h"
+#include "game_settings.h"
+
+// Storage policies for BasicGameBoard (see game_board.h).
+//
+// A storage owns the cells and the scratch buffers of the board. The logic
+// is written once against this interface:
+//
+//   settings()           current GameSettings
+//   layout()             layout of the cells (with sentinel ring):
+//                        BoardLayout, or TiledBoardLayout for wide boards
+//   plane_layout()       BoardLayout of the byte planes below, which are
+//                        row-major whatever the cell layout
+//   set_settings(s)      switch dimensions, returns false if not supported
+//   reserve(n)           make room for n cells without releasing memory
+//   clear()              reset every cell to its default state in place
+//   copy_cells(other)    take other's settings, cells and row revisions,
+//                        not its scratch buffers (for read-only copies)
+//   cells()              pointer to layout().padded_size() cells
+//   opened_cells()       list of cells opened by a click as layout() indices,
+//                        with room for every in-board cell
+//   bomb_mask()          scratch byte plane, one byte per (padded) cell
+//   bomb_counts()        scratch byte plane, one byte per (padded) cell
+//   row_revisions()      board revision of the last change to each row, by
+//                        padded row (rows + 2 entries)
+
+// Reset the cells of a padded board: in-board cells to their default state,
+// and the sentinel ring to open, bomb-free cells
+inline void clear_cells(Cell* cells, const BoardLayout& layout) {
+  Cell sentinel;
+  sentinel.open();
+
+  const unsigned int stride = layout.stride();
+  const unsigned int last_row = layout.rows + 1;
+  for (unsigned int col = 0; col < stride; ++col) {
+    cells[col] = sentinel;
+    cells[last_row * stride + col] = sentinel;
+  }
+  for (unsigned int row = 1; row <= layout.rows; ++row) {
+    Cell* row_cells = cells + row * stride;
+    row_cells[0] = sentinel;
+    for (unsigned int col = 1; col <= layout.columns; ++col) {
+      row_cells[col] = Cell();
+    }
+    row_cells[stride - 1] = sentinel;
+  }
+}
+
+// Same for the tiled layout, in one pass in memory order. The padding of the
+// edge tiles is never in-board and is kept as sentinels too.
+inline void clear_cells(Cell* cells, const TiledBoardLayout& layout) {
+  constexpr unsigned int kTileSize = TiledBoardLayout::kTileSize;
+  Cell sentinel;
+  sentinel.open();
+
+  Cell* cell = cells;
+  for (unsigned int tile_row = 0; tile_row < layout.tile_rows(); ++tile_row) {
+    for (unsigned int tile = 0; tile < layout.tile_columns(); ++tile) {
+      for (unsigned int y = 0; y < kTileSize; ++y) {
+        // Padded coordinates; the board is rows and columns 1 to rows/columns
+        unsigned int row = tile_row * kTileSize + y;
+        bool board_row = row >= 1 && row <= layout.rows;
+        for (unsigned int x = 0; x < kTileSize; ++x, ++cell) {
+          unsigned int col = tile * kTileSize + x;
+          *cell = board_row && col >= 1 && col <= layout.columns ? Cell()
+                                                                 : sentinel;
+        }
+      }
+    }
+  }
+}
+
+// Runtime-sized storage. Used for the interactive game, where the difficulty
+// changes at runtime, and for custom board sizes. Use the DynamicBoardStorage
+// and TiledBoardStorage aliases below.
+template <typename Layout>
+class BasicDynamicBoardStorage {
+ public:
+  BasicDynamicBoardStorage()
+      : settings_(GameSettings::from_difficulty(Difficulty::Normal)) {}
+
+  const GameSettings& settings() const { return settings_; }
+  Layout layout() const { return Layout{settings_.rows, settings_.columns}; }
+  BoardLayout plane_layout() const {
+    return BoardLayout{settings_.rows, settings_.columns};
+  }
+
+  bool set_settings(const GameSettings& settings) {
+    if (!Layout::fits(settings.rows, settings.columns)) {
+      return false;
+    }
+    settings_ = settings;
+    return true;
+  }
+
+  void reserve(unsigned int cell_count) {
+    cells_.reserve(cell_count);
+    opened_cells_.reserve(cell_count);
+    bomb_mask_.reserve(cell_count);
+    bomb_counts_.reserve(cell_count);
+  }
+
+  void clear() {
+    // resize() only reallocates when the capacity is too small, so restarting
+    // a game of the same (or a smaller) size never touches the heap
+    const Layout cell_layout = layout();
+    const BoardLayout planes = plane_layout();
+    reserve(std::max(cell_layout.padded_size(), planes.padded_size()));
+    cells_.resize(cell_layout.padded_size());
+    opened_cells_.resize(settings_.cell_count());
+    bomb_mask_.resize(planes.padded_size());
+    bomb_counts_.resize(planes.padded_size());
+    clear_cells(cells_.data(), cell_layout);
+    row_revisions_.resize(settings_.rows + 2);
+  }
+
+  void copy_cells(const BasicDynamicBoardStorage& other) {
+    settings_ = other.settings_;
+    // Both reuse the capacity when it is large enough
+    cells_ = other.cells_;
+    row_revisions_ = other.row_revisions_;
+  }
+
+  Cell* cells() { return cells_.data(); }
+  const Cell* cells() const { return cells_.data(); }
+  unsigned int* opened_cells() { return opened_cells_.data(); }
+  const unsigned int* opened_cells() const { return opened_cells_.data(); }
+  std::uint8_t* bomb_mask() { return bomb_mask_.data(); }
+  std::uint8_t* bomb_counts() { return bomb_counts_.data(); }
+  std::uint64_t* row_revisions() { return row_revisions_.data(); }
+  const std::uint64_t* row_revisions() const { return row_revisions_.data(); }
+
+ private:
+  GameSettings settings_;
+  std::vector<Cell> cells_;
+  std::vector<unsigned int> opened_cells_;
+  std::vector<std::uint8_t> bomb_mask_;
+  std::vector<std::uint8_t> bomb_counts_;
+  std::vector<std::uint64_t> row_revisions_;
+};
+
+using DynamicBoardStorage = BasicDynamicBoardStorage<BoardLayout>;
+
+// Cells in 8 x 8 tiles, for flood fills on boards thousands of columns wide
+// (see TiledBoardLayout)
+using TiledBoardStorage = BasicDynamicBoardStorage<TiledBoardLayout>;
+
+// Compile-time sized storage backed by std::array. The layout and neighbor
+// offsets are constants, so the board loops unroll and never allocate.
+template <unsigned int Rows, unsigned int Columns, unsigned int Bombs>
+class FixedBoardStorage {
+ public:
+  static_assert(Rows > 0 && Columns > 0, "Board must not be empty");
+  static_assert(Bombs < Rows * Columns, "Too many bombs for the board");
+
+  static constexpr GameSettings kSettings =
+      GameSettings::from_dimensions(Rows, Columns, Bombs);
+  static constexpr BoardLayout kLayout{Rows, Columns};
+
+  const GameSettings& settings() const { return kSettings; }
+  static constexpr BoardLayout layout() { return kLayout; }
+  static constexpr BoardLayout plane_layout() { return kLayout; }
+
+  // The dimensions are fixed; only the identical settings are accepted
+  bool set_settings(const GameSettings& settings) {
+    return settings.rows == Rows && settings.columns == Columns &&
+           settings.bombs == Bombs;
+  }
+
+  void reserve(unsigned int) {}
+  void clear() { clear_cells(cells_.data(), kLayout); }
+  void copy_cells(const FixedBoardStorage& other) {
+    cells_ = other.cells_;
+    row_revisions_ = other.row_revisions_;
+  }
+
+  Cell* cells() { return cells_.data(); }
+  const Cell* cells() const { return cells_.data(); }
+  unsigned int* opened_cells() { return opened_cells_.data(); }
+  const unsigned int* opened_cells() const { return opened_cells_.data(); }
+  std::uint8_t* bomb_mask() { return bomb_mask_.data(); }
+  std::uint8_t* bomb_counts() { return bomb_counts_.data(); }
+  std::uint64_t* row_revisions() { return row_revisions_.data(); }
+  const std::uint64_t* row_revisions() const { return row_revisions_.data(); }
+
+ private:
+  std::array<Cell, kLayout.padded_size()> cells_;
+  std::array<unsigned int, Rows * Columns> opened_cells_;
+  std::array<std::uint8_t, kLayout.padded_size()> bomb_mask_;
+  std::array<std::uint8_t, kLayout.padded_size()> bomb_counts_;
+  std::array<std::uint64_t, Rows + 2> row_revisions_;
+};
+
+// Fixed-size storage matching one of the presets
+template <Difficulty D>
+using PresetBoardStorage =
+    FixedBoardStorage<GameSettings::from_difficulty(D).rows,
+                      GameSettings::from_difficulty(D).columns,
+                      GameSettings::from_difficulty(D).bombs>;
+
+#endif  // BOARD_STORAGE_H_
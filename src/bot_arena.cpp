@@ -0,0 +1,151 @@
+#include "bot_arena.h"
+
+#include <chrono>
+
+#include "alloc_tracker.h"
+#include "trace.h"
+
+namespace {
+
+// Pace of the bots, so games can be watched
+constexpr std::chrono::milliseconds kStepInterval(40);
+// Steps a finished board stays on screen before it is reset
+constexpr unsigned int kRestartSteps = 25;
+
+}  // namespace
+
+BotArena::BotArena(unsigned int board_count, Difficulty difficulty)
+    : seats_(board_count),
+      games_won_(0),
+      games_lost_(0),
+      rng_(std::random_device{}()),
+      running_(false) {
+  for (Seat& seat : seats_) {
+    seat.board.change_difficulty(difficulty);
+  }
+  // Make the initial boards visible before the thread starts
+  publish();
+}
+
+BotArena::~BotArena() { stop(); }
+
+void BotArena::start() {
+  if (running_.exchange(true)) {
+    return;  // Already running
+  }
+  thread_ = std::thread(&BotArena::run, this);
+}
+
+void BotArena::stop() {
+  if (!running_.exchange(false)) {
+    return;  // Not running
+  }
+  thread_.join();
+}
+
+void BotArena::run() {
+  AllocScope alloc_scope(AllocTag::Logic);
+  trace_set_thread_name("Bots");
+  auto next_step = std::chrono::steady_clock::now();
+  while (running_.load()) {
+    step();
+    publish();
+    next_step += kStepInterval;
+    std::this_thread::sleep_until(next_step);
+  }
+}
+
+void BotArena::step() {
+  TRACE_SCOPE("BotArena::step");
+  for (Seat& seat : seats_) {
+    if (seat.board.get_game_state() != GameState::Playing) {
+      if (seat.restart_delay > 0 && --seat.restart_delay == 0) {
+        seat.board.reset();
+      }
+      continue;
+    }
+    if (!play_move(seat.board)) {
+      if (seat.board.get_game_state() == GameState::Cleared) {
+        ++games_won_;
+      } else {
+        ++games_lost_;
+      }
+      seat.restart_delay = kRestartSteps;
+    }
+  }
+}
+
+bool BotArena::play_move(GameBoard& board) {
+  const int rows = static_cast<int>(board.get_rows());
+  const int columns = static_cast<int>(board.get_columns());
+
+  // Look for a number whose closed neighbors are all safe or all bombs.
+  // Flags are only ever placed by this rule, so they are always right.
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < columns; ++col) {
+      const Cell& cell = board.get_cell(row, col);
+      if (!cell.is_open() || cell.get_bomb_count() == 0) {
+        continue;
+      }
+      int flagged = 0;
+      int closed = 0;
+      int closed_row = 0;
+      int closed_col = 0;
+      for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+          int r = row + dr;
+          int c = col + dc;
+          if (r < 0 || r >= rows || c < 0 || c >= columns) {
+            continue;
+          }
+          const Cell& neighbor = board.get_cell(r, c);
+          if (neighbor.is_open()) {
+            continue;
+          }
+          if (neighbor.has_flag()) {
+            ++flagged;
+          } else {
+            ++closed;
+            closed_row = r;
+            closed_col = c;
+          }
+        }
+      }
+      if (closed == 0) {
+        continue;
+      }
+      int count = static_cast<int>(cell.get_bomb_count());
+      if (count == flagged) {
+        return board.open_cell(closed_row, closed_col);
+      }
+      if (count == flagged + closed) {
+        board.toggle_flag(closed_row, closed_col);
+        return true;
+      }
+    }
+  }
+
+  // Nothing certain: open the first closed cell from a random position
+  std::uniform_int_distribution<int> cell_index(0, rows * columns - 1);
+  int start = cell_index(rng_);
+  for (int i = 0; i < rows * columns; ++i) {
+    int n = (start + i) % (rows * columns);
+    const Cell& cell = board.get_cell(n / columns, n % columns);
+    if (!cell.is_open() && !cell.has_flag()) {
+      return board.open_cell(n / columns, n % columns);
+    }
+  }
+  return false;
+}
+
+void BotArena::publish() {
+  ArenaSnapshot& snapshot = snapshots_.back();
+  // Sized on the first publish into each buffer; later copies reuse storage
+  snapshot.boards.resize(seats_.size());
+  for (std::size_t i = 0; i < seats_.size(); ++i) {
+    snapshot.boards[i] = seats_[i].board;
+  }
+  snapshot.games_won = games_won_;
+  snapshot.games_lost = games_lost_;
+  snapshots_.publish();
+}
@@ -0,0 +1,64 @@
+#ifndef BOT_ARENA_H_
+#define BOT_ARENA_H_
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "game_board.h"
+#include "game_settings.h"
+#include "triple_buffer.h"
+
+// State of every game in the arena, as published to the render thread
+struct ArenaSnapshot {
+  std::vector<GameBoard> boards;
+  unsigned int games_won = 0;
+  unsigned int games_lost = 0;
+};
+
+// Plays many games at once for the spectator view (main --spectate).
+//
+// A simple bot plays every board on the arena's own thread, one move per
+// board per step: it opens or flags cells that a single number proves safe
+// or mined, and otherwise opens a random closed cell. Finished boards are
+// shown for a moment, then reset.
+class BotArena {
+ public:
+  BotArena(unsigned int board_count, Difficulty difficulty);
+  ~BotArena();
+
+  // Start / stop the arena thread
+  void start();
+  void stop();
+
+  // Render thread only. Newest state of all boards; valid until the next
+  // call.
+  const ArenaSnapshot& latest() { return snapshots_.front(); }
+
+ private:
+  // Per board
+  struct Seat {
+    GameBoard board;
+    // Steps left before a finished board is reset
+    unsigned int restart_delay = 0;
+  };
+
+  std::vector<Seat> seats_;
+  unsigned int games_won_;
+  unsigned int games_lost_;
+  std::mt19937_64 rng_;
+  TripleBuffer<ArenaSnapshot> snapshots_;
+
+  std::thread thread_;
+  std::atomic<bool> running_;
+
+  void run();
+  void step();
+  // Make one move on the board. Returns false if the game ended.
+  bool play_move(GameBoard& board);
+  void publish();
+};
+
+#endif  // BOT_ARENA_H_
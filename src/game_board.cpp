@@ -1,57 +1,151 @@
 #include "game_board.h"
 
-#include <random>
+#include <algorithm>
+
+#include "board_generator.h"
+#include "trace.h"
+
+template <typename Storage>
+BasicGameBoard<Storage>::BasicGameBoard()
+    : opened_count_(0),
+      revision_(0),
+      generated_(false),
+      rng_(std::random_device{}()),
+      seed_(0),
+      generation_threads_(0) {
+  // Allocate once for the largest preset; later games reuse this memory
+  storage_.reserve(
+      BoardLayout{kLargestPreset.rows, kLargestPreset.columns}.padded_size());
+
+  // Initialize cells; bombs come with the first click
+  reset();
+}
 
-GameBoard::GameBoard() {
-  game_state_ = GameState::Playing;
-  settings_ = GameSettings::from_difficulty(Difficulty::Normal);
-
-  // Initialize cells with default constructor
-  cells_.resize(settings_.rows * settings_.columns);
-  // and put bombs and counts
-  deploy_bombs_and_counts();
-}
-
-GameState GameBoard::get_game_state() const { return game_state_; }
-
-bool GameBoard::is_valid_point(unsigned int row, unsigned int column) {
-  return (row >= 0 && row < settings_.rows && column >= 0 &&
-          column < settings_.columns);
-}
-
-void GameBoard::deploy_bombs_and_counts() {
-  const int directions[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
-                                {0, 1},   {1, -1}, {1, 0},  {1, 1}};
-
-  // Use modern C++ random number generation
-  std::random_device rd;   // Non-deterministic random seed
-  std::mt19937 gen(rd());  // Mersenne Twister engine
-  std::uniform_int_distribution<unsigned int> dist(0, cells_.size() - 1);
-
-  unsigned int bombs_count = 0;
-  while (bombs_count < settings_.bombs) {
-    // Deploy bomb at random index
-    unsigned int index = dist(gen);
-    if (!cells_[index].has_bomb()) {
-      cells_[index].set_bomb();
-      bombs_count++;
-
-      // Update adjacent cells' bomb counts
-      unsigned int row = index / settings_.columns;
-      unsigned int col = index % settings_.columns;
-      for (const auto& dir : directions) {
-        int new_row = static_cast<int>(row) + dir[0];
-        int new_col = static_cast<int>(col) + dir[1];
-        if (is_valid_point(new_row, new_col)) {
-          unsigned int neighbor_index = new_row * settings_.columns + new_col;
-          cells_[neighbor_index].increment_count();
-        }
+template <typename Storage>
+GameState BasicGameBoard<Storage>::get_game_state() const {
+  return game_state_;
+}
+
+template <typename Storage>
+bool BasicGameBoard<Storage>::is_valid_point(unsigned int row,
+                                             unsigned int column) {
+  // Negative coordinates wrap around to large values and fail here as well
+  return row < get_rows() && column < get_columns();
+}
+
+template <typename Storage>
+void BasicGameBoard<Storage>::deploy_bombs_and_counts(
+    const SafeZone* safe_zone) {
+  TRACE_SCOPE("GameBoard::deploy_bombs_and_counts");
+  const BoardLayout layout = storage_.plane_layout();
+  std::uint8_t* mask = storage_.bomb_mask();
+  std::uint8_t* counts = storage_.bomb_counts();
+  const unsigned int threads =
+      generation_thread_count(layout, generation_threads_);
+
+  // Place bombs in a byte mask and count them with SIMD (board_generator.h)
+  generate_bombs(layout, storage_.settings().bombs, seed_, threads, safe_zone,
+                 mask, counts);
+  apply_bombs_and_counts(threads);
+}
+
+template <typename Storage>
+void BasicGameBoard<Storage>::apply_bombs_and_counts(unsigned int threads) {
+  Cell* cells = storage_.cells();
+  const auto layout = storage_.layout();
+  const BoardLayout planes = storage_.plane_layout();
+  const std::uint8_t* mask = storage_.bomb_mask();
+  const std::uint8_t* counts = storage_.bomb_counts();
+
+  // Copy the result into the cells, band by band, in the cells' memory order
+  for_each_band(generation_band_count(planes), threads, [&](unsigned int band) {
+    layout.for_each_cell_in_rows(
+        generation_band_begin(band), generation_band_end(planes, band),
+        [&](unsigned int index, unsigned int row, unsigned int col) {
+          unsigned int plane_index = planes.index(row, col);
+          if (mask[plane_index]) {
+            cells[index].set_bomb();
+          }
+          cells[index].set_count(counts[plane_index]);
+        });
+  });
+  generated_ = true;
+}
+
+template <typename Storage>
+void BasicGameBoard<Storage>::generate() {
+  if (!generated_) {
+    deploy_bombs_and_counts(nullptr);
+  }
+}
+
+template <typename Storage>
+bool BasicGameBoard<Storage>::load_bombs(const std::uint8_t* bits,
+                                         std::uint64_t seed) {
+  TRACE_SCOPE("GameBoard::load_bombs");
+  reset(seed);
+
+  // Expand the bits into the padded mask; the sentinel ring stays 0
+  const BoardLayout layout = storage_.plane_layout();
+  std::uint8_t* mask = storage_.bomb_mask();
+  std::fill(mask, mask + layout.padded_size(), 0);
+  unsigned int bombs = 0;
+  unsigned int bit = 0;
+  for (unsigned int row = 0; row < layout.rows; ++row) {
+    std::uint8_t* row_mask = mask + layout.index(row, 0);
+    for (unsigned int col = 0; col < layout.columns; ++col, ++bit) {
+      std::uint8_t bomb = (bits[bit >> 3] >> (bit & 7)) & 1;
+      row_mask[col] = bomb;
+      bombs += bomb;
+    }
+  }
+  if (bombs != storage_.settings().bombs) {
+    return false;
+  }
+
+  const unsigned int threads =
+      generation_thread_count(layout, generation_threads_);
+  count_bombs(layout, threads, mask, storage_.bomb_counts());
+  apply_bombs_and_counts(threads);
+  return true;
+}
+
+template <typename Storage>
+bool BasicGameBoard<Storage>::store_bombs(std::uint8_t* bits) const {
+  if (!generated_) {
+    return false;  // No bombs to store
+  }
+  const unsigned int rows = get_rows();
+  const unsigned int columns = get_columns();
+  std::fill(bits, bits + (rows * columns + 7) / 8, 0);
+  unsigned int bit = 0;
+  for (unsigned int row = 0; row < rows; ++row) {
+    for (unsigned int col = 0; col < columns; ++col, ++bit) {
+      if (get_cell(row, col).has_bomb()) {
+        bits[bit >> 3] |= static_cast<std::uint8_t>(1u << (bit & 7));
       }
     }
   }
+  return true;
+}
+
+template <typename Storage>
+void BasicGameBoard<Storage>::copy_visible_state(const BasicGameBoard& other) {
+  storage_.copy_cells(other.storage_);
+  game_state_ = other.game_state_;
+  closed_safe_cells_ = other.closed_safe_cells_;
+  opened_count_ = 0;
+  revision_ = other.revision_;
+  timer_ = other.timer_;
+  generated_ = other.generated_;
+  seed_ = other.seed_;
 }
 
-bool GameBoard::open_cell(unsigned int row, unsigned int column) {
+template <typename Storage>
+bool BasicGameBoard<Storage>::open_cell(unsigned int row, unsigned int column) {
+  TRACE_SCOPE("GameBoard::open_cell");
+  opened_count_ = 0;
+
   // Check if game is already over
   if (game_state_ != GameState::Playing) {
     return false;
@@ -62,8 +156,8 @@ bool GameBoard::open_cell(unsigned int row, unsigned int column) {
     return true;  // Invalid click, but game continues
   }
 
-  unsigned int index = row * settings_.columns + column;
-  Cell& cell = cells_[index];
+  unsigned int index = storage_.layout().index(row, column);
+  Cell& cell = storage_.cells()[index];
 
   // Check if cell is already open
   if (cell.is_open()) {
@@ -75,100 +169,153 @@ bool GameBoard::open_cell(unsigned int row, unsigned int column) {
     return true;  // Flagged, don't open
   }
 
-  // Open the cell
+  // The first click places the bombs around it. Keep its neighbors clear
+  // too when the board has room, so the first click opens an area.
+  if (!generated_) {
+    const BoardLayout layout = storage_.plane_layout();
+    SafeZone safe_zone{row, column, 1};
+    if (storage_.settings().bombs >
+        layout.rows * layout.columns -
+            safe_zone.cell_count(layout, 0, layout.rows)) {
+      safe_zone.radius = 0;
+    }
+    deploy_bombs_and_counts(&safe_zone);
+  }
+
+  // Open the cell; the first one starts the timer
   cell.open();
+  storage_.opened_cells()[0] = index;
+  opened_count_ = 1;
+  ++revision_;
+  storage_.row_revisions()[row + 1] = revision_;
+  timer_.start();
 
   // Check if it's a bomb
   if (cell.has_bomb()) {
     game_state_ = GameState::GameOver;
+    timer_.stop();
     return false;  // Game over!
   }
+  closed_safe_cells_--;
 
-  // If cell has no adjacent bombs, recursively open neighbors
+  // If cell has no adjacent bombs, flood-open its neighbors
   if (cell.get_bomb_count() == 0) {
-    open_cell_recursive(row, column);
+    open_cell_flood();
   }
 
   // Check if game is cleared (all non-bomb cells are open)
-  if (check_game_cleared()) {
+  if (closed_safe_cells_ == 0) {
     game_state_ = GameState::Cleared;
+    timer_.stop();
     return false;  // Game cleared!
   }
 
   return true;  // Game continues
 }
 
-void GameBoard::open_cell_recursive(unsigned int row, unsigned int column) {
-  // Directions: 8 adjacent cells
-  const int directions[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
-                                {0, 1},   {1, -1}, {1, 0},  {1, 1}};
-
-  for (const auto& dir : directions) {
-    int new_row = static_cast<int>(row) + dir[0];
-    int new_col = static_cast<int>(column) + dir[1];
-
-    // Check if position is valid
-    if (!is_valid_point(new_row, new_col)) {
+template <typename Storage>
+void BasicGameBoard<Storage>::open_cell_flood() {
+  TRACE_SCOPE("GameBoard::open_cell_flood");
+  Cell* cells = storage_.cells();
+  const auto layout = storage_.layout();
+  unsigned int* opened = storage_.opened_cells();
+  std::uint64_t* row_revisions = storage_.row_revisions();
+
+  // Breadth-first over the list of opened cells: every cell opened is
+  // appended once, and zero cells are expanded as the scan reaches them. No
+  // recursion, and the list doubles as the record of what this click opened.
+  for (unsigned int next = 0; next < opened_count_; ++next) {
+    unsigned int current = opened[next];
+    if (cells[current].get_bomb_count() != 0) {
       continue;
     }
 
-    unsigned int index = new_row * settings_.columns + new_col;
-    Cell& cell = cells_[index];
+    // Neighbors span the rows above and below; the sentinel rows have
+    // entries too, so no bounds check
+    const unsigned int padded_row = layout.padded_row(current);
+    row_revisions[padded_row - 1] = revision_;
+    row_revisions[padded_row] = revision_;
+    row_revisions[padded_row + 1] = revision_;
 
-    // Skip if already open or has bomb
-    if (cell.is_open() || cell.has_bomb()) {
-      continue;
-    }
+    layout.for_each_neighbor(current, [&](unsigned int neighbor_index) {
+      Cell& cell = cells[neighbor_index];
 
-    // Open the cell
-    cell.open();
+      // Skip if already open (sentinels always are) or has bomb
+      if (cell.is_open() || cell.has_bomb()) {
+        return;
+      }
 
-    // If this cell also has no adjacent bombs, recursively open its neighbors
-    if (cell.get_bomb_count() == 0) {
-      open_cell_recursive(new_row, new_col);
-    }
+      // Open the cell; it is expanded later if it has no adjacent bombs
+      cell.open();
+      closed_safe_cells_--;
+      opened[opened_count_++] = neighbor_index;
+    });
   }
 }
 
-void GameBoard::toggle_flag(unsigned int row, unsigned int column) {
+template <typename Storage>
+void BasicGameBoard<Storage>::toggle_flag(unsigned int row,
+                                          unsigned int column) {
   // Check if position is valid
   if (!is_valid_point(row, column)) {
     return;  // Invalid position
   }
 
-  unsigned int index = row * settings_.columns + column;
-  Cell& cell = cells_[index];
+  unsigned int index = storage_.layout().index(row, column);
+  Cell& cell = storage_.cells()[index];
 
   // Toggle the flag on the cell
   cell.toggle_flag();
+  ++revision_;
+  storage_.row_revisions()[row + 1] = revision_;
 }
 
-bool GameBoard::check_game_cleared() {
-  for (const auto& cell : cells_) {
-    // If there's a non-bomb cell that is not open, game is not cleared
-    if (!cell.has_bomb() && !cell.is_open()) {
-      return false;
-    }
-  }
-  // All non-bomb cells are open
-  return true;
+template <typename Storage>
+void BasicGameBoard<Storage>::reset() {
+  reset(rng_());
 }
 
-void GameBoard::reset() {
+template <typename Storage>
+void BasicGameBoard<Storage>::reset(std::uint64_t seed) {
   // Reset game state
   game_state_ = GameState::Playing;
 
-  // Clear all cells (resize will call default constructor)
-  cells_.clear();
-  cells_.resize(settings_.rows * settings_.columns);
+  seed_ = seed;
+  opened_count_ = 0;
+  ++revision_;
+  timer_.reset();
+
+  // Clear all cells in place (no reallocation for known board sizes). Bombs
+  // and counts are deferred to the first click.
+  storage_.clear();
+  const GameSettings& settings = storage_.settings();
+  std::fill(storage_.row_revisions(),
+            storage_.row_revisions() + settings.rows + 2, revision_);
+  closed_safe_cells_ = settings.cell_count() - settings.bombs;
+  generated_ = false;
+}
 
-  // Deploy new bombs and recalculate counts
-  deploy_bombs_and_counts();
+template <typename Storage>
+void BasicGameBoard<Storage>::change_difficulty(Difficulty difficulty) {
+  // Update difficulty and settings, then reset the game with new settings
+  change_settings(GameSettings::from_difficulty(difficulty));
 }
 
-void GameBoard::change_difficulty(Difficulty difficulty) {
-  // Update difficulty and settings
-  settings_ = GameSettings::from_difficulty(difficulty);
-  // Reset the game with new settings
+template <typename Storage>
+bool BasicGameBoard<Storage>::change_settings(const GameSettings& settings) {
+  // A board needs at least one safe cell and indices that don't wrap
+  if (!settings.is_valid()) {
+    return false;
+  }
+  if (!storage_.set_settings(settings)) {
+    return false;
+  }
   reset();
+  return true;
 }
+
+template class BasicGameBoard<DynamicBoardStorage>;
+template class BasicGameBoard<TiledBoardStorage>;
+template class BasicGameBoard<PresetBoardStorage<Difficulty::Easy>>;
+template class BasicGameBoard<PresetBoardStorage<Difficulty::Normal>>;
+template class BasicGameBoard<PresetBoardStorage<Difficulty::Hard>>;
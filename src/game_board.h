@@ -1,17 +1,25 @@
 #ifndef GAME_BOARD_H_
 #define GAME_BOARD_H_
 
-#include <vector>
+#include <cstdint>
+#include <random>
 
+#include "board_storage.h"
 #include "cell.h"
 #include "game_settings.h"
+#include "game_timer.h"
 
 enum class GameState { Playing, GameOver, Cleared };
 
-class GameBoard {
+struct SafeZone;  // board_generator.h
+
+// Game logic, parameterized on how cells are stored (see board_storage.h).
+// Use the GameBoard / FixedGameBoard aliases below rather than this directly.
+template <typename Storage>
+class BasicGameBoard {
  public:
   // Constructor
-  GameBoard();
+  BasicGameBoard();
 
   // Get the current game state
   GameState get_game_state() const;
@@ -23,29 +31,135 @@ class GameBoard {
   // Right click to toggle flag on a cell at (row, column)
   void toggle_flag(unsigned int row, unsigned int column);
 
-  // Reset the game (restart)
+  // Reset the game (restart) with a new random board. Only clears the
+  // cells: the bombs are placed by the first open_cell(), never on the
+  // clicked cell or its neighbors.
   void reset();
 
+  // Reset the game with the board generated from `seed`. The same seed,
+  // settings and first click always give the same board.
+  void reset(std::uint64_t seed);
+
+  // Place the bombs now, without a first click to keep clear. For tools that
+  // inspect whole boards. Does nothing if the bombs are already placed.
+  void generate();
+
+  // Reset the game with a stored bomb layout instead of generating one (see
+  // board_corpus.h). `bits` holds one bit per cell in row-major order, least
+  // significant bit first; bit (row * columns + column) is set for a bomb.
+  // get_seed() reports `seed` afterwards. Returns false, leaving the board
+  // reset but empty, if the number of set bits doesn't match the settings.
+  bool load_bombs(const std::uint8_t* bits, std::uint64_t seed);
+
+  // Write the bombs in the format of load_bombs(): (cells + 7) / 8 bytes.
+  // Returns false, writing nothing, if the board isn't generated yet.
+  bool store_bombs(std::uint8_t* bits) const;
+
+  // False from a reset until the bombs are placed
+  bool is_generated() const { return generated_; }
+
+  // Become a read-only copy of what `other` shows: its settings, cells,
+  // state, revision and timer. The bomb planes, the opened-cell list and the
+  // random engine are not copied, so this costs one copy of the cells. The
+  // copy reports no opened cells and must not be played.
+  void copy_visible_state(const BasicGameBoard& other);
+
   // Change difficulty and reset the game
   void change_difficulty(Difficulty difficulty);
 
+  // Change to arbitrary dimensions and reset the game
+  // Returns false (and leaves the board untouched) if the storage can't hold
+  // boards of that size, e.g. a fixed-size board
+  bool change_settings(const GameSettings& settings);
+
   // Getters for rendering
-  unsigned int get_rows() const { return settings_.rows; }
-  unsigned int get_columns() const { return settings_.columns; }
+  unsigned int get_rows() const { return storage_.settings().rows; }
+  unsigned int get_columns() const { return storage_.settings().columns; }
+  unsigned int get_bombs() const { return storage_.settings().bombs; }
   const Cell& get_cell(unsigned int row, unsigned int col) const {
-    return cells_[row * settings_.columns + col];
+    return storage_.cells()[storage_.layout().index(row, col)];
+  }
+  Difficulty get_difficulty() const { return storage_.settings().difficulty; }
+  // BoardLayout, or TiledBoardLayout for a TiledGameBoard
+  auto get_layout() const { return storage_.layout(); }
+
+  // Cells opened by the last open_cell() call, as get_layout() indices. The
+  // clicked cell comes first; empty if the click changed nothing.
+  const unsigned int* get_opened_cells() const {
+    return storage_.opened_cells();
+  }
+  unsigned int get_opened_count() const { return opened_count_; }
+
+  // Time from the first opened cell to the end of the game
+  const GameTimer& get_timer() const { return timer_; }
+
+  // Bumped by every change to the cells, so observers of a copy (e.g. the
+  // renderer) can skip work when nothing changed
+  std::uint64_t get_revision() const { return revision_; }
+
+  // Revision of the last change to `row`. An observer that has seen
+  // revision R only needs the rows whose revision is greater than R; a reset
+  // changes every row.
+  std::uint64_t get_row_revision(unsigned int row) const {
+    return storage_.row_revisions()[row + 1];
+  }
+
+  // Seed of the current board
+  std::uint64_t get_seed() const { return seed_; }
+
+  // Threads used to generate large boards (see board_generator.h). 0, the
+  // default, means one per core. Does not change the generated boards.
+  void set_generation_threads(unsigned int threads) {
+    generation_threads_ = threads;
   }
-  Difficulty get_difficulty() const { return settings_.difficulty; }
 
  private:
   GameState game_state_;
-  GameSettings settings_;
-  std::vector<Cell> cells_;
+  Storage storage_;
+  // Safe cells that are still closed; the game is cleared when it hits zero
+  unsigned int closed_safe_cells_;
+  // Length of the storage's opened_cells() list for the last click
+  unsigned int opened_count_;
+  std::uint64_t revision_;
+  GameTimer timer_;
+  // Bombs and counts have been placed since the last reset
+  bool generated_;
+
+  // Random engine, seeded once and used to pick a seed for every new game
+  std::mt19937_64 rng_;
+  std::uint64_t seed_;
+  unsigned int generation_threads_;
 
   bool is_valid_point(unsigned int row, unsigned int column);
-  void deploy_bombs_and_counts();
-  void open_cell_recursive(unsigned int row, unsigned int column);
-  bool check_game_cleared();
+  // Place bombs outside safe_zone (may be null) and compute the counts
+  void deploy_bombs_and_counts(const SafeZone* safe_zone);
+  // Copy the storage's bomb mask and counts into the cells
+  void apply_bombs_and_counts(unsigned int threads);
+  void open_cell_flood();
 };
 
+// Runtime-sized board. Used by the game itself.
+using GameBoard = BasicGameBoard<DynamicBoardStorage>;
+
+// Runtime-sized board with its cells in tiles. Faster flood fills on boards
+// thousands of columns wide, slower row-major scans through get_cell().
+using TiledGameBoard = BasicGameBoard<TiledBoardStorage>;
+
+// Compile-time sized board with std::array storage
+template <unsigned int Rows, unsigned int Columns, unsigned int Bombs>
+using FixedGameBoard = BasicGameBoard<FixedBoardStorage<Rows, Columns, Bombs>>;
+
+// Fixed-size boards for the presets
+using EasyGameBoard = BasicGameBoard<PresetBoardStorage<Difficulty::Easy>>;
+using NormalGameBoard = BasicGameBoard<PresetBoardStorage<Difficulty::Normal>>;
+using HardGameBoard = BasicGameBoard<PresetBoardStorage<Difficulty::Hard>>;
+
+// The member functions are defined in game_board.cpp and instantiated there
+// for the runtime-sized boards and the presets only
+extern template class BasicGameBoard<DynamicBoardStorage>;
+extern template class BasicGameBoard<TiledBoardStorage>;
+extern template class BasicGameBoard<PresetBoardStorage<Difficulty::Easy>>;
+extern template class BasicGameBoard<PresetBoardStorage<Difficulty::Normal>>;
+extern template class BasicGameBoard<PresetBoardStorage<Difficulty::Hard>>;
+
 #endif  // GAME_BOARD_H_
@@ -1,7 +1,9 @@
 #ifndef GAME_SETTINGS_H_
 #define GAME_SETTINGS_H_
 
-enum class Difficulty { Easy, Normal, Hard };
+#include <cstdint>
+
+enum class Difficulty { Easy, Normal, Hard, Custom };
 
 struct GameSettings {
  public:
@@ -10,7 +12,7 @@ struct GameSettings {
   unsigned int columns;
   unsigned int bombs;
 
-  static GameSettings from_difficulty(Difficulty difficulty) {
+  static constexpr GameSettings from_difficulty(Difficulty difficulty) {
     switch (difficulty) {
       case Difficulty::Easy:
         return GameSettings{difficulty, 9, 9, 10};
@@ -22,8 +24,41 @@ struct GameSettings {
         return GameSettings{difficulty, 13, 13, 25};
     }
   }
+
+  // Settings for arbitrary dimensions. Matches a preset if the dimensions are
+  // identical to one, otherwise the difficulty is Custom.
+  static constexpr GameSettings from_dimensions(unsigned int rows,
+                                                unsigned int columns,
+                                                unsigned int bombs) {
+    for (Difficulty preset :
+         {Difficulty::Easy, Difficulty::Normal, Difficulty::Hard}) {
+      GameSettings settings = from_difficulty(preset);
+      if (settings.rows == rows && settings.columns == columns &&
+          settings.bombs == bombs) {
+        return settings;
+      }
+    }
+    return GameSettings{Difficulty::Custom, rows, columns, bombs};
+  }
+
+  constexpr unsigned int cell_count() const { return rows * columns; }
+
+  // Whether a board can be created with these settings: at least one safe
+  // cell, and every cell including the sentinel ring (see board_layout.h)
+  // indexable with unsigned int. Larger dimensions would wrap around.
+  constexpr bool is_valid() const {
+    return rows != 0 && columns != 0 &&
+           (std::uint64_t{rows} + 2) * (std::uint64_t{columns} + 2) <=
+               UINT32_MAX &&
+           bombs < cell_count();
+  }
 };
 
+// The largest preset. Boards reserve memory for it up front so switching
+// between presets never reallocates.
+constexpr GameSettings kLargestPreset =
+    GameSettings::from_difficulty(Difficulty::Hard);
+
 // UI configuration constants
 namespace UIConfig {
 // Height of the console bar in pixels
@@ -31,4 +66,12 @@ namespace UIConfig {
 constexpr float kConsoleBarHeight = 60.0f;
 }  // namespace UIConfig
 
+// Where a board is drawn, in pixels from the top-left corner of the window
+struct BoardRect {
+  float x;
+  float y;
+  float width;
+  float height;
+};
+
 #endif  // GAME_SETTINGS_H_
@@ -0,0 +1,139 @@
+#include "game_simulation.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "alloc_tracker.h"
+#include "trace.h"
+
+GameSimulation::GameSimulation() : running_(false), sleeping_(false) {
+  // Make the initial board visible before the thread starts
+  publish(0);
+}
+
+GameSimulation::~GameSimulation() { stop(); }
+
+void GameSimulation::start() {
+  if (running_.exchange(true)) {
+    return;  // Already running
+  }
+  thread_ = std::thread(&GameSimulation::run, this);
+}
+
+void GameSimulation::stop() {
+  if (!running_.exchange(false)) {
+    return;  // Not running
+  }
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+  }
+  wake_.notify_one();
+  thread_.join();
+}
+
+bool GameSimulation::push_input(const InputEvent& event) {
+  if (!input_queue_.try_push(event)) {
+    return false;
+  }
+  // Pairs with the fence in run(): either this sees sleeping_ set, or the
+  // logic thread sees the event before it waits. Only a parked thread needs
+  // the mutex, which orders the wakeup with its empty check.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_.notify_one();
+  }
+  return true;
+}
+
+void GameSimulation::run() {
+  AllocScope alloc_scope(AllocTag::Logic);
+  trace_set_thread_name("Logic");
+  while (running_.load()) {
+    if (input_queue_.empty()) {
+      sleeping_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_.wait(lock, [this] {
+          return !input_queue_.empty() || !running_.load();
+        });
+      }
+      sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+    // Apply everything queued so far, then publish once
+    bool changed = false;
+    std::uint64_t trace_flow = 0;
+    InputEvent event;
+    while (input_queue_.try_pop(event)) {
+      apply(event);
+      changed = true;
+      if (event.trace_flow != 0) {
+        trace_flow = event.trace_flow;
+      }
+    }
+    if (changed) {
+      publish(trace_flow);
+    }
+  }
+}
+
+void GameSimulation::apply(const InputEvent& event) {
+  TRACE_SCOPE("GameSimulation::apply");
+  TRACE_FLOW_STEP(event.trace_flow);
+  switch (event.type) {
+    case InputEvent::Type::OpenCell: {
+      // Open the cell
+      bool was_playing = board_.get_game_state() == GameState::Playing;
+      bool game_continues = board_.open_cell(event.row, event.column);
+      if (!game_continues) {
+        GameState state = board_.get_game_state();
+        if (state == GameState::Cleared) {
+          std::cout << "Congratulations! You cleared the game!" << std::endl;
+        } else if (state == GameState::GameOver) {
+          std::cout << "Game Over! You hit a bomb!" << std::endl;
+        }
+        if (was_playing && state != GameState::Playing) {
+          report_result();
+        }
+      }
+      break;
+    }
+    case InputEvent::Type::ToggleFlag:
+      board_.toggle_flag(event.row, event.column);
+      break;
+    case InputEvent::Type::Reset:
+      board_.reset();
+      break;
+    case InputEvent::Type::ChangeDifficulty:
+      board_.change_difficulty(event.difficulty);
+      break;
+  }
+}
+
+void GameSimulation::report_result() {
+  using namespace std::chrono;
+  GameResult result;
+  result.difficulty = board_.get_difficulty();
+  result.cleared = board_.get_game_state() == GameState::Cleared;
+  result.duration_us = static_cast<std::uint64_t>(
+      duration_cast<microseconds>(board_.get_timer().elapsed()).count());
+  result.finished_at =
+      duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+  // Stats are best effort; if the render thread falls this far behind,
+  // dropping a result beats blocking the game
+  result_queue_.try_push(result);
+}
+
+void GameSimulation::publish(std::uint64_t trace_flow) {
+  TRACE_SCOPE("GameSimulation::publish");
+  // Only the visible state; the copy reuses the snapshot's storage when the
+  // size matches
+  BoardSnapshot& snapshot = snapshots_.back();
+  snapshot.board.copy_visible_state(board_);
+  snapshot.trace_flow = trace_flow;
+  snapshots_.publish();
+}
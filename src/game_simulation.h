@@ -0,0 +1,103 @@
+#ifndef GAME_SIMULATION_H_
+#define GAME_SIMULATION_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "game_board.h"
+#include "game_settings.h"
+#include "spsc_queue.h"
+#include "stats_store.h"
+#include "triple_buffer.h"
+
+// Player input, queued from the render thread to the game-logic thread
+struct InputEvent {
+  enum class Type { OpenCell, ToggleFlag, Reset, ChangeDifficulty };
+
+  Type type;
+  unsigned int row;
+  unsigned int column;
+  Difficulty difficulty;
+  // Trace flow from the input callback to the frame showing the result
+  // (see trace.h); 0 if not traced
+  std::uint64_t trace_flow = 0;
+
+  static InputEvent open_cell(unsigned int row, unsigned int column) {
+    return InputEvent{Type::OpenCell, row, column, Difficulty::Normal};
+  }
+  static InputEvent toggle_flag(unsigned int row, unsigned int column) {
+    return InputEvent{Type::ToggleFlag, row, column, Difficulty::Normal};
+  }
+  static InputEvent reset() {
+    return InputEvent{Type::Reset, 0, 0, Difficulty::Normal};
+  }
+  static InputEvent change_difficulty(Difficulty difficulty) {
+    return InputEvent{Type::ChangeDifficulty, 0, 0, difficulty};
+  }
+};
+
+// What the logic thread publishes after each batch of input
+struct BoardSnapshot {
+  // What the player sees of the board (see GameBoard::copy_visible_state())
+  GameBoard board;
+  // Trace flow of the last input applied to the board; 0 if none
+  std::uint64_t trace_flow = 0;
+};
+
+// Runs the game logic on its own thread, so flood fills and board generation
+// never stall a frame.
+//
+// The render thread pushes InputEvents and reads the latest board snapshot;
+// the logic thread owns the board, applies the events and publishes a copy
+// after each batch. Neither side takes a lock on the hot path.
+class GameSimulation {
+ public:
+  GameSimulation();
+  ~GameSimulation();
+
+  // Start / stop the game-logic thread
+  void start();
+  void stop();
+
+  // Render thread only. Returns false if the queue is full and the event was
+  // dropped.
+  bool push_input(const InputEvent& event);
+
+  // Render thread only. Newest board published by the logic thread; valid
+  // until the next call.
+  const BoardSnapshot& latest() { return snapshots_.front(); }
+  const GameBoard& latest_board() { return latest().board; }
+
+  // Render thread only. Takes the next finished game, if any.
+  bool pop_result(GameResult& result) { return result_queue_.try_pop(result); }
+
+ private:
+  static constexpr std::size_t kInputQueueSize = 256;
+  static constexpr std::size_t kResultQueueSize = 64;
+
+  // Owned by the logic thread once started
+  GameBoard board_;
+
+  SpscQueue<InputEvent, kInputQueueSize> input_queue_;
+  SpscQueue<GameResult, kResultQueueSize> result_queue_;
+  TripleBuffer<BoardSnapshot> snapshots_;
+
+  std::thread thread_;
+  std::atomic<bool> running_;
+  // Set while the logic thread waits for input; only then does push_input()
+  // take wake_mutex_ to wake it
+  std::atomic<bool> sleeping_;
+  // Only used to put the logic thread to sleep while there is no input
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+
+  void run();
+  void apply(const InputEvent& event);
+  void publish(std::uint64_t trace_flow);
+  void report_result();
+};
+
+#endif  // GAME_SIMULATION_H_
@@ -0,0 +1,51 @@
+#ifndef GAME_TIMER_H_
+#define GAME_TIMER_H_
+
+#include <chrono>
+
+// Measures a game from the first opened cell to the end of the game, on the
+// monotonic clock so wall-clock adjustments don't affect it
+class GameTimer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  void reset() {
+    started_ = false;
+    stopped_ = false;
+  }
+
+  // Starts the timer unless it is already running or stopped
+  void start() {
+    if (!started_) {
+      start_ = Clock::now();
+      started_ = true;
+    }
+  }
+
+  // Stops a running timer
+  void stop() {
+    if (started_ && !stopped_) {
+      stop_ = Clock::now();
+      stopped_ = true;
+    }
+  }
+
+  bool has_started() const { return started_; }
+  bool is_running() const { return started_ && !stopped_; }
+
+  // Time since start, frozen once stopped. Zero before the first click.
+  Clock::duration elapsed() const {
+    if (!started_) {
+      return Clock::duration::zero();
+    }
+    return (stopped_ ? stop_ : Clock::now()) - start_;
+  }
+
+ private:
+  Clock::time_point start_;
+  Clock::time_point stop_;
+  bool started_ = false;
+  bool stopped_ = false;
+};
+
+#endif  // GAME_TIMER_H_
@@ -0,0 +1,327 @@
+#include "hint_engine.h"
+
+#include <algorithm>
+
+#include "alloc_tracker.h"
+#include "trace.h"
+
+namespace {
+
+// Codes in Job::cells: 0-8 an open cell showing that number
+constexpr std::uint8_t kClosed = 9;
+constexpr std::uint8_t kOutside = 10;  // Sentinel ring
+
+// What the analysis has proven about a closed cell
+constexpr std::uint8_t kUnknown = 0;
+constexpr std::uint8_t kSafe = 1;
+constexpr std::uint8_t kMine = 2;
+
+// Work between two cancellation checks
+constexpr unsigned int kCancelCheckInterval = 4096;
+
+// Closed neighbors of a numbered cell that aren't proven yet, and the bombs
+// among them still to be placed
+struct Constraint {
+  unsigned int unknown[8];
+  unsigned int unknown_count;
+  int bombs;
+
+  bool contains(unsigned int index) const {
+    return std::find(unknown, unknown + unknown_count, index) !=
+           unknown + unknown_count;
+  }
+};
+
+Constraint collect(const BoardLayout& layout, const std::uint8_t* cells,
+                   const std::uint8_t* known, unsigned int index) {
+  Constraint constraint;
+  constraint.unknown_count = 0;
+  constraint.bombs = cells[index];
+  layout.for_each_neighbor(index, [&](unsigned int neighbor) {
+    if (cells[neighbor] != kClosed) {
+      return;
+    }
+    if (known[neighbor] == kMine) {
+      --constraint.bombs;
+    } else if (known[neighbor] == kUnknown) {
+      constraint.unknown[constraint.unknown_count++] = neighbor;
+    }
+  });
+  return constraint;
+}
+
+}  // namespace
+
+HintEngine::HintEngine() : requested_revision_(0), running_(false) {}
+
+HintEngine::~HintEngine() { stop(); }
+
+void HintEngine::start() {
+  if (running_.exchange(true)) {
+    return;  // Already running
+  }
+  thread_ = std::thread(&HintEngine::run, this);
+}
+
+void HintEngine::stop() {
+  if (!running_.exchange(false)) {
+    return;  // Not running
+  }
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+  }
+  wake_.notify_one();
+  thread_.join();
+}
+
+void HintEngine::request(const GameBoard& board) {
+  std::uint64_t revision = board.get_revision();
+  if (revision == requested_revision_.load(std::memory_order_relaxed)) {
+    return;  // Already requested
+  }
+  AllocScope alloc_scope(AllocTag::Hints);
+
+  // Copy what the player can see; the worker never sees the board itself
+  Job& job = jobs_.back();
+  job.revision = revision;
+  job.playing = board.get_game_state() == GameState::Playing;
+  job.generated = board.is_generated();
+  job.layout = board.get_layout();
+  job.bombs = board.get_bombs();
+  job.cells.assign(job.layout.padded_size(), kOutside);
+  for (unsigned int row = 0; row < job.layout.rows; ++row) {
+    std::uint8_t* codes = job.cells.data() + job.layout.index(row, 0);
+    for (unsigned int col = 0; col < job.layout.columns; ++col) {
+      const Cell& cell = board.get_cell(row, col);
+      codes[col] = cell.is_open()
+                       ? static_cast<std::uint8_t>(cell.get_bomb_count())
+                       : kClosed;
+    }
+  }
+  jobs_.publish();
+
+  // Publishing before the store lets the worker find the job once it sees
+  // the new revision; the store also cancels the analysis in progress
+  requested_revision_.store(revision, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+  }
+  wake_.notify_one();
+}
+
+void HintEngine::run() {
+  AllocScope alloc_scope(AllocTag::Hints);
+  trace_set_thread_name("Hints");
+  std::uint64_t processed_revision = 0;
+  while (running_.load()) {
+    {
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      wake_.wait(lock, [&] {
+        return requested_revision_.load(std::memory_order_acquire) !=
+                   processed_revision ||
+               !running_.load();
+      });
+    }
+    if (!running_.load()) {
+      break;
+    }
+
+    const Job& job = jobs_.front();
+    processed_revision = job.revision;
+    Hint& hint = results_.back();
+    if (analyze(job, hint)) {
+      results_.publish();
+    }
+  }
+}
+
+bool HintEngine::is_cancelled(const Job& job) const {
+  return !running_.load(std::memory_order_relaxed) ||
+         requested_revision_.load(std::memory_order_relaxed) != job.revision;
+}
+
+bool HintEngine::analyze(const Job& job, Hint& hint) {
+  TRACE_SCOPE("HintEngine::analyze");
+  hint.revision = job.revision;
+  hint.safe_cells.clear();
+  hint.has_guess = false;
+  if (!job.playing) {
+    return true;  // Nothing to suggest once the game is over
+  }
+  const BoardLayout& layout = job.layout;
+  if (!job.generated) {
+    // No bombs yet and the first click never hits one; the center is as
+    // safe as any cell and most likely to open an area
+    hint.has_guess = true;
+    hint.guess = {layout.rows / 2, layout.columns / 2};
+    hint.guess_risk = 0.0f;
+    return true;
+  }
+
+  const std::uint8_t* cells = job.cells.data();
+  std::vector<std::uint8_t>& known = known_;
+  known.assign(layout.padded_size(), kUnknown);
+  unsigned int known_mines = 0;
+
+  // Numbered cells whose neighborhood may allow a new deduction
+  std::vector<unsigned int>& worklist = worklist_;
+  std::vector<std::uint8_t>& queued = queued_;
+  worklist.clear();
+  queued.assign(layout.padded_size(), 0);
+  // Both hold each cell at most once. Reserving for every cell, and the
+  // guess's risks up front, allocates once per board size, not whenever a
+  // position needs more than before.
+  worklist.reserve(layout.rows * layout.columns);
+  hint.safe_cells.reserve(layout.rows * layout.columns);
+  risk_.reserve(layout.padded_size());
+  auto enqueue = [&](unsigned int index) {
+    if (cells[index] > 0 && cells[index] <= 8 && !queued[index]) {
+      queued[index] = 1;
+      worklist.push_back(index);
+    }
+  };
+  auto mark = [&](unsigned int index, std::uint8_t value) {
+    known[index] = value;
+    if (value == kMine) {
+      ++known_mines;
+    }
+    layout.for_each_neighbor(index, enqueue);
+  };
+  layout.for_each_cell(enqueue);
+
+  unsigned int work = 0;
+  while (true) {
+    // A number whose bombs are all found makes the rest safe; a number with
+    // as many closed neighbors as bombs makes them all bombs
+    while (!worklist.empty()) {
+      if (++work % kCancelCheckInterval == 0 && is_cancelled(job)) {
+        return false;
+      }
+      unsigned int index = worklist.back();
+      worklist.pop_back();
+      queued[index] = 0;
+
+      Constraint c = collect(layout, cells, known.data(), index);
+      if (c.unknown_count == 0) {
+        continue;
+      }
+      if (c.bombs == 0 || c.bombs == static_cast<int>(c.unknown_count)) {
+        std::uint8_t value = c.bombs == 0 ? kSafe : kMine;
+        for (unsigned int i = 0; i < c.unknown_count; ++i) {
+          mark(c.unknown[i], value);
+        }
+      }
+    }
+
+    // Pairs of nearby numbers: if A's unknown cells are a subset of B's, the
+    // cells only B sees hold exactly B's bombs minus A's
+    const int stride = static_cast<int>(layout.stride());
+    for (unsigned int row = 0; row < layout.rows; ++row) {
+      for (unsigned int col = 0; col < layout.columns; ++col) {
+        if (++work % kCancelCheckInterval == 0 && is_cancelled(job)) {
+          return false;
+        }
+        unsigned int a_index = layout.index(row, col);
+        if (cells[a_index] == 0 || cells[a_index] > 8) {
+          continue;
+        }
+        Constraint a = collect(layout, cells, known.data(), a_index);
+        if (a.unknown_count == 0) {
+          continue;
+        }
+
+        // Numbers sharing a closed neighbor with A are at most 2 cells away
+        for (int dr = -2; dr <= 2; ++dr) {
+          for (int dc = -2; dc <= 2; ++dc) {
+            int r = static_cast<int>(row) + dr;
+            int c = static_cast<int>(col) + dc;
+            if ((dr == 0 && dc == 0) || r < 0 || c < 0 ||
+                r >= static_cast<int>(layout.rows) ||
+                c >= static_cast<int>(layout.columns)) {
+              continue;
+            }
+            unsigned int b_index = a_index + dr * stride + dc;
+            if (cells[b_index] == 0 || cells[b_index] > 8) {
+              continue;
+            }
+            Constraint b = collect(layout, cells, known.data(), b_index);
+            if (b.unknown_count <= a.unknown_count ||
+                !std::all_of(a.unknown, a.unknown + a.unknown_count,
+                             [&](unsigned int i) { return b.contains(i); })) {
+              continue;
+            }
+            int extra_bombs = b.bombs - a.bombs;
+            unsigned int extra_cells = b.unknown_count - a.unknown_count;
+            if (extra_bombs != 0 &&
+                extra_bombs != static_cast<int>(extra_cells)) {
+              continue;
+            }
+            std::uint8_t value = extra_bombs == 0 ? kSafe : kMine;
+            for (unsigned int i = 0; i < b.unknown_count; ++i) {
+              if (!a.contains(b.unknown[i])) {
+                mark(b.unknown[i], value);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // Marks from the pair pass queue their neighbors for another round
+    if (worklist.empty()) {
+      break;
+    }
+  }
+
+  // Report the proven safe cells
+  unsigned int unknown_cells = 0;
+  layout.for_each_cell([&](unsigned int index) {
+    if (cells[index] != kClosed) {
+      return;
+    }
+    if (known[index] == kSafe) {
+      hint.safe_cells.push_back(
+          {index / layout.stride() - 1, index % layout.stride() - 1});
+    } else if (known[index] == kUnknown) {
+      ++unknown_cells;
+    }
+  });
+  if (!hint.safe_cells.empty() || unknown_cells == 0) {
+    return true;
+  }
+
+  // Otherwise guess. Cells next to numbers take the worst bomb ratio of
+  // those numbers; the rest share the bombs left over evenly.
+  std::vector<float>& risk = risk_;
+  risk.assign(layout.padded_size(), -1.0f);
+  layout.for_each_cell([&](unsigned int index) {
+    if (cells[index] == 0 || cells[index] > 8) {
+      return;
+    }
+    Constraint c = collect(layout, cells, known.data(), index);
+    float ratio = static_cast<float>(c.bombs) / c.unknown_count;
+    for (unsigned int i = 0; i < c.unknown_count; ++i) {
+      risk[c.unknown[i]] = std::max(risk[c.unknown[i]], ratio);
+    }
+  });
+  if (is_cancelled(job)) {
+    return false;
+  }
+
+  float density =
+      static_cast<float>(job.bombs > known_mines ? job.bombs - known_mines
+                                                 : 0) /
+      unknown_cells;
+  layout.for_each_cell([&](unsigned int index) {
+    if (cells[index] != kClosed || known[index] != kUnknown) {
+      return;
+    }
+    float cell_risk = risk[index] >= 0.0f ? risk[index] : density;
+    if (!hint.has_guess || cell_risk < hint.guess_risk) {
+      hint.has_guess = true;
+      hint.guess = {index / layout.stride() - 1, index % layout.stride() - 1};
+      hint.guess_risk = cell_risk;
+    }
+  });
+  return true;
+}
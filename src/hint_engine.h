@@ -0,0 +1,90 @@
+#ifndef HINT_ENGINE_H_
+#define HINT_ENGINE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "board_layout.h"
+#include "game_board.h"
+#include "triple_buffer.h"
+
+// Analysis of what the player can see on a board
+struct Hint {
+  struct Point {
+    unsigned int row;
+    unsigned int column;
+  };
+
+  // Board revision (GameBoard::get_revision()) the hint was computed for
+  std::uint64_t revision = 0;
+  // Closed cells that can't hold a bomb, given the numbers shown
+  std::vector<Point> safe_cells;
+  // With no safe cell, the closed cell least likely to hold a bomb
+  bool has_guess = false;
+  Point guess = {0, 0};
+  // Estimated chance that the guess is a bomb
+  float guess_risk = 0.0f;
+};
+
+// Computes hints on a worker thread so large boards never stall a frame.
+//
+// The render thread calls request() with the board on screen and draws
+// latest() once its revision matches. A request for a newer revision
+// cancels the analysis in progress. Only the visible state is copied to the
+// worker: the engine never looks at hidden bombs, and flags are ignored
+// since they may be wrong.
+class HintEngine {
+ public:
+  HintEngine();
+  ~HintEngine();
+
+  // Start / stop the worker thread
+  void start();
+  void stop();
+
+  // Render thread only. Queues the board for analysis unless its revision
+  // was already requested.
+  void request(const GameBoard& board);
+
+  // Render thread only. Newest finished hint; valid until the next call.
+  const Hint& latest() { return results_.front(); }
+
+ private:
+  // Visible state of a board, as handed to the worker
+  struct Job {
+    std::uint64_t revision = 0;
+    bool playing = false;
+    bool generated = false;  // False until the first click places the bombs
+    unsigned int bombs = 0;
+    BoardLayout layout = {0, 0};
+    // Padded like the board (see board_layout.h); one code per cell
+    std::vector<std::uint8_t> cells;
+  };
+
+  TripleBuffer<Job> jobs_;
+  TripleBuffer<Hint> results_;
+  // Newest revision handed to request(); older analyses stop early
+  std::atomic<std::uint64_t> requested_revision_;
+
+  std::thread thread_;
+  std::atomic<bool> running_;
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+
+  // Worker scratch, kept between analyses so steady play doesn't allocate
+  std::vector<std::uint8_t> known_;
+  std::vector<std::uint8_t> queued_;
+  std::vector<unsigned int> worklist_;
+  std::vector<float> risk_;
+
+  void run();
+  // Returns false if cancelled before finishing
+  bool analyze(const Job& job, Hint& hint);
+  bool is_cancelled(const Job& job) const;
+};
+
+#endif  // HINT_ENGINE_H_
@@ -3,9 +3,11 @@
 #include <iostream>
 
 #include "game_settings.h"
+#include "trace.h"
 
-InputHandler::InputHandler(GLFWwindow* window, GameBoard* board)
-    : window_(window), board_(board) {}
+InputHandler::InputHandler(GLFWwindow* window, GameSimulation* simulation,
+                           ViewOptions* view)
+    : window_(window), simulation_(simulation), view_(view) {}
 
 InputHandler::~InputHandler() {
   // Clear callbacks
@@ -48,8 +50,10 @@ std::tuple<unsigned int, unsigned int> InputHandler::get_clicked_cell() {
   int width, height;
   glfwGetWindowSize(window_, &width, &height);
 
-  unsigned int rows = board_->get_rows();
-  unsigned int cols = board_->get_columns();
+  // Dimensions of the board currently on screen
+  const GameBoard& board = simulation_->latest_board();
+  unsigned int rows = board.get_rows();
+  unsigned int cols = board.get_columns();
 
   // Account for console bar at the top
   // Subtract console bar height from y position
@@ -70,55 +74,92 @@ std::tuple<unsigned int, unsigned int> InputHandler::get_clicked_cell() {
 }
 
 void InputHandler::handle_mouse_button(int button, int action, int mods) {
+  TRACE_SCOPE("InputHandler::handle_mouse_button");
   if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
     // Get mouse position
     unsigned int row, col;
     std::tie(row, col) = get_clicked_cell();
 
     // Check if click is within valid board area
-    if (row >= board_->get_rows() || col >= board_->get_columns()) {
+    const GameBoard& board = simulation_->latest_board();
+    if (row >= board.get_rows() || col >= board.get_columns()) {
       return;  // Click outside board area (e.g., in console bar)
     }
 
-    // Open the cell
-    bool game_continues = board_->open_cell(row, col);
-    if (!game_continues) {
-      GameState state = board_->get_game_state();
-      if (state == GameState::Cleared) {
-        std::cout << "Congratulations! You cleared the game!" << std::endl;
-      } else if (state == GameState::GameOver) {
-        std::cout << "Game Over! You hit a bomb!" << std::endl;
-      }
-    }
+    // Open the cell on the game-logic thread
+    push_input(InputEvent::open_cell(row, col));
   } else if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) {
     // Right-click handling (e.g., flagging a cell) can be added here
     unsigned int row, col;
     std::tie(row, col) = get_clicked_cell();
 
     // Check if click is within valid board area
-    if (row >= board_->get_rows() || col >= board_->get_columns()) {
+    const GameBoard& board = simulation_->latest_board();
+    if (row >= board.get_rows() || col >= board.get_columns()) {
       return;  // Click outside board area (e.g., in console bar)
     }
 
-    board_->toggle_flag(row, col);
+    push_input(InputEvent::toggle_flag(row, col));
   }
 }
 
 void InputHandler::handle_key(int key, int scancode, int action, int mods) {
+  TRACE_SCOPE("InputHandler::handle_key");
   // Press 'R' to restart the game
   if (key == GLFW_KEY_R && action == GLFW_PRESS) {
-    board_->reset();
-    std::cout << "Game restarted! Press 'R' to restart again." << std::endl;
+    if (push_input(InputEvent::reset())) {
+      std::cout << "Game restarted! Press 'R' to restart again." << std::endl;
+    }
   }
   // Press '1', '2', '3' to change difficulty
   else if (key == GLFW_KEY_1 && action == GLFW_PRESS) {
-    board_->change_difficulty(Difficulty::Easy);
-    std::cout << "Difficulty changed to Easy (9x9, 10 bombs)" << std::endl;
+    if (push_input(InputEvent::change_difficulty(Difficulty::Easy))) {
+      std::cout << "Difficulty changed to Easy (9x9, 10 bombs)" << std::endl;
+    }
   } else if (key == GLFW_KEY_2 && action == GLFW_PRESS) {
-    board_->change_difficulty(Difficulty::Normal);
-    std::cout << "Difficulty changed to Normal (16x16, 25 bombs)" << std::endl;
+    if (push_input(InputEvent::change_difficulty(Difficulty::Normal))) {
+      std::cout << "Difficulty changed to Normal (16x16, 25 bombs)"
+                << std::endl;
+    }
   } else if (key == GLFW_KEY_3 && action == GLFW_PRESS) {
-    board_->change_difficulty(Difficulty::Hard);
-    std::cout << "Difficulty changed to Hard (25x25, 60 bombs)" << std::endl;
+    if (push_input(InputEvent::change_difficulty(Difficulty::Hard))) {
+      std::cout << "Difficulty changed to Hard (25x25, 60 bombs)" << std::endl;
+    }
+  }
+  // Press 'G' to switch between texture and per-cell board rendering
+  else if (key == GLFW_KEY_G && action == GLFW_PRESS) {
+    view_->gpu_board = !view_->gpu_board;
+    std::cout << "Board rendering: "
+              << (view_->gpu_board ? "texture" : "per-cell quads") << std::endl;
+  }
+  // Press 'H' to show or hide hints
+  else if (key == GLFW_KEY_H && action == GLFW_PRESS) {
+    view_->hints = !view_->hints;
+    std::cout << "Hints " << (view_->hints ? "on" : "off") << std::endl;
+  }
+  // Press 'F3' to show or hide the allocation panel
+  else if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+    view_->allocation_panel = !view_->allocation_panel;
+  }
+  // Press 'F9' to write the trace recorded so far
+  else if (key == GLFW_KEY_F9 && action == GLFW_PRESS) {
+    if (trace_path().empty()) {
+      std::cout << "Tracing is off; set MINESWEEPER_TRACE to a file name"
+                << std::endl;
+    } else if (trace_flush()) {
+      std::cout << "Trace written to " << trace_path() << std::endl;
+    } else {
+      std::cerr << "Failed to write trace to " << trace_path() << std::endl;
+    }
+  }
+}
+
+bool InputHandler::push_input(InputEvent event) {
+  event.trace_flow = TRACE_FLOW_BEGIN();
+  if (!simulation_->push_input(event)) {
+    TRACE_FLOW_END(event.trace_flow);
+    std::cerr << "The game is busy; input ignored" << std::endl;
+    return false;
   }
+  return true;
 }
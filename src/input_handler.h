@@ -5,11 +5,13 @@
 
 #include <tuple>
 
-#include "game_board.h"
+#include "game_simulation.h"
+#include "view_options.h"
 
 class InputHandler {
  public:
-  InputHandler(GLFWwindow* window, GameBoard* board);
+  InputHandler(GLFWwindow* window, GameSimulation* simulation,
+               ViewOptions* view);
   ~InputHandler();
 
   // Setup input callbacks
@@ -17,7 +19,10 @@ class InputHandler {
 
  private:
   GLFWwindow* window_;
-  GameBoard* board_;
+  // Input is forwarded to the game-logic thread through the simulation
+  GameSimulation* simulation_;
+  // Display toggles, read by the renderer each frame
+  ViewOptions* view_;
 
   // Static callback functions (required by GLFW C API)
   static void mouse_button_callback(GLFWwindow* window, int button, int action,
@@ -33,6 +38,11 @@ class InputHandler {
 
   // Instance method for handling keyboard events
   void handle_key(int key, int scancode, int action, int mods);
+
+  // Forward an event to the game-logic thread, starting its trace flow.
+  // Returns false, after telling the player, if the event was dropped
+  // because the logic thread is too far behind.
+  bool push_input(InputEvent event);
 };
 
 #endif  // INPUT_HANDLER_H_
@@ -1,14 +1,112 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <cstdlib>
+#include <exception>
 #include <iostream>
+#include <string>
 
-#include "game_board.h"
+#include "alloc_tracker.h"
+#include "bot_arena.h"
+#include "game_simulation.h"
+#include "hint_engine.h"
 #include "input_handler.h"
 #include "renderer.h"
+#include "stats_store.h"
+#include "trace.h"
 #include "ui_manager.h"
+#include "view_options.h"
+
+namespace {
+
+struct Options {
+  // Boards to watch bots play; 0 plays a game instead
+  unsigned int spectate = 0;
+};
+
+void print_usage() {
+  std::cerr << "Usage: Minesweeper [--spectate N]" << std::endl;
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      bool has_value = i + 1 < argc;
+      if (arg == "--spectate" && has_value) {
+        options.spectate = static_cast<unsigned int>(std::stoul(argv[++i]));
+      } else {
+        return false;
+      }
+    }
+  } catch (const std::exception&) {
+    return false;  // Not a number
+  }
+  return true;
+}
+
+// Write the trace recorded so far, if tracing was started
+void flush_trace() {
+  if (trace_path().empty()) {
+    return;
+  }
+  if (trace_flush()) {
+    std::cout << "Trace written to " << trace_path() << std::endl;
+  } else {
+    std::cerr << "Failed to write trace to " << trace_path() << std::endl;
+  }
+}
+
+// Spectator view: bots play many boards at once, all drawn in one frame
+void run_spectator(GLFWwindow* window, Renderer& renderer,
+                   UIManager& ui_manager, unsigned int board_count) {
+  BotArena arena(board_count, Difficulty::Normal);
+  arena.start();
+
+  while (!glfwWindowShouldClose(window)) {
+    TRACE_SCOPE("Frame");
+    glfwPollEvents();
+
+    // Latest boards published by the arena thread
+    const ArenaSnapshot& snapshot = arena.latest();
+
+    {
+      AllocScope alloc_scope(AllocTag::Render);
+      renderer.render_boards(snapshot.boards);
+    }
+    {
+      AllocScope alloc_scope(AllocTag::UI);
+      // Quad fallback: the UI draws the numbers
+      ui_manager.render_spectator(snapshot,
+                                  renderer.draws_cell_labels()
+                                      ? nullptr
+                                      : renderer.board_rects().data());
+    }
+
+    {
+      TRACE_SCOPE("glfwSwapBuffers");
+      glfwSwapBuffers(window);
+    }
+  }
+
+  arena.stop();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    print_usage();
+    return 1;
+  }
+
+  // Timeline tracing (see trace.h), written on exit and with F9
+  if (const char* trace_file = std::getenv("MINESWEEPER_TRACE")) {
+    trace_start(trace_file);
+  }
+  trace_set_thread_name("Render");
 
-int main() {
   // 1. Initialize GLFW
   if (!glfwInit()) {
     std::cerr << "Failed to initialize GLFW" << std::endl;
@@ -38,9 +136,7 @@ int main() {
     return -1;
   }
 
-  // 4. Create game board, renderer, UI manager, and input handler
-  GameBoard board = GameBoard();
-
+  // 4. Create renderer, UI manager, game simulation, and input handler
   Renderer renderer(window);
   if (!renderer.initialize()) {
     std::cerr << "Failed to initialize renderer" << std::endl;
@@ -56,27 +152,107 @@ int main() {
     return -1;
   }
 
-  InputHandler input_handler(window, &board);
+  if (options.spectate > 0) {
+    run_spectator(window, renderer, ui_manager, options.spectate);
+    ui_manager.cleanup();
+    renderer.cleanup();
+    glfwTerminate();
+    flush_trace();
+    return 0;
+  }
+
+  // Only a game needs these, not the spectator. The simulation owns the
+  // board and runs the game logic on its own thread
+  GameSimulation simulation;
+
+  // Finished games are logged here; without the file, stats are kept for
+  // this session only
+  StatsStore stats;
+  stats.open("minesweeper_stats.bin");
+
+  ViewOptions view;
+  InputHandler input_handler(window, &simulation, &view);
   input_handler.setup_callbacks();
 
+  // Hints are analysed on their own thread as well
+  HintEngine hint_engine;
+
+  simulation.start();
+  hint_engine.start();
+
+  // Heap allocations of the previous frame, for the debug panel
+  AllocSnapshot frame_start = alloc_snapshot();
+  AllocSnapshot last_frame_allocations;
+
+  // Last input flow whose result reached the screen
+  std::uint64_t shown_trace_flow = 0;
+
   // 5. Main loop
   while (!glfwWindowShouldClose(window)) {
+    TRACE_SCOPE("Frame");
+
     // Process events
-    glfwPollEvents();
+    {
+      TRACE_SCOPE("glfwPollEvents");
+      glfwPollEvents();
+    }
+
+    // Latest board published by the game-logic thread
+    const BoardSnapshot& snapshot = simulation.latest();
+    const GameBoard& board = snapshot.board;
+
+    // Record games the logic thread has finished
+    GameResult result;
+    while (simulation.pop_result(result)) {
+      stats.append(result);
+    }
 
     // Render the game board
-    renderer.render(board);
+    {
+      AllocScope alloc_scope(AllocTag::Render);
+      renderer.render(board, view);
+    }
+
+    // Ask for hints on this board; show them once they match it
+    const Hint* hint = nullptr;
+    if (view.hints) {
+      hint_engine.request(board);
+      const Hint& latest = hint_engine.latest();
+      if (latest.revision == board.get_revision()) {
+        hint = &latest;
+      }
+    }
 
     // Render UI
-    ui_manager.render(board);
+    {
+      AllocScope alloc_scope(AllocTag::UI);
+      ui_manager.render(board, stats, !renderer.draws_cell_labels(), hint,
+                        view.allocation_panel ? &last_frame_allocations
+                                              : nullptr);
+    }
+
+    // Swap buffers. The first frame showing an input's result ends its flow.
+    {
+      TRACE_SCOPE("glfwSwapBuffers");
+      glfwSwapBuffers(window);
+      if (snapshot.trace_flow != shown_trace_flow) {
+        TRACE_FLOW_END(snapshot.trace_flow);
+        shown_trace_flow = snapshot.trace_flow;
+      }
+    }
 
-    // Swap buffers
-    glfwSwapBuffers(window);
+    // Everything allocated since the last frame, on any thread
+    AllocSnapshot frame_end = alloc_snapshot();
+    last_frame_allocations = alloc_difference(frame_end, frame_start);
+    frame_start = frame_end;
   }
 
   // 6. Cleanup
+  hint_engine.stop();
+  simulation.stop();
   ui_manager.cleanup();
   renderer.cleanup();
   glfwTerminate();
+  flush_trace();
   return 0;
 }
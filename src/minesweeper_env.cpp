@@ -0,0 +1,153 @@
+#include "minesweeper_env.h"
+
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "game_board.h"
+
+struct MsVecEnv {
+  GameSettings settings;
+  std::uint64_t next_seed;
+  std::vector<GameBoard> boards;
+};
+
+namespace {
+
+// Observation values besides the counts 0-8 (see minesweeper_env.h)
+constexpr std::uint8_t kObservationClosed = 9;
+constexpr std::uint8_t kObservationFlag = 10;
+constexpr std::uint8_t kObservationBomb = 11;
+
+std::uint8_t encode_cell(const Cell& cell) {
+  if (!cell.is_open()) {
+    return cell.has_flag() ? kObservationFlag : kObservationClosed;
+  }
+  if (cell.has_bomb()) {
+    return kObservationBomb;
+  }
+  return static_cast<std::uint8_t>(cell.get_bomb_count());
+}
+
+void write_observation(const GameBoard& board, std::uint8_t* observation) {
+  const unsigned int columns = board.get_columns();
+  for (unsigned int row = 0; row < board.get_rows(); ++row) {
+    for (unsigned int col = 0; col < columns; ++col) {
+      observation[row * columns + col] = encode_cell(board.get_cell(row, col));
+    }
+  }
+}
+
+// Rewrite only the cells opened by the board's last click
+void write_opened_cells(const GameBoard& board, std::uint8_t* observation) {
+  const BoardLayout layout = board.get_layout();
+  const unsigned int* opened = board.get_opened_cells();
+  for (unsigned int i = 0; i < board.get_opened_count(); ++i) {
+    unsigned int n = opened[i] - layout.begin_index();
+    unsigned int row = n / layout.stride();
+    unsigned int col = n % layout.stride();
+    observation[row * layout.columns + col] =
+        encode_cell(board.get_cell(row, col));
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+MsVecEnv* ms_vec_env_create(uint32_t num_envs, uint32_t rows, uint32_t columns,
+                            uint32_t bombs, uint64_t seed) {
+  GameSettings settings = GameSettings::from_dimensions(rows, columns, bombs);
+  // Every action (2 per cell) must also fit in an int32_t
+  if (num_envs == 0 || !settings.is_valid() ||
+      2 * std::uint64_t{settings.cell_count()} > INT32_MAX) {
+    return nullptr;
+  }
+
+  MsVecEnv* env = new (std::nothrow) MsVecEnv{settings, seed, {}};
+  if (env == nullptr) {
+    return nullptr;
+  }
+  try {
+    env->boards.resize(num_envs);
+    for (GameBoard& board : env->boards) {
+      board.change_settings(settings);
+    }
+  } catch (const std::bad_alloc&) {
+    delete env;
+    return nullptr;
+  }
+  return env;
+}
+
+void ms_vec_env_destroy(MsVecEnv* env) { delete env; }
+
+uint32_t ms_vec_env_num_envs(const MsVecEnv* env) {
+  return static_cast<uint32_t>(env->boards.size());
+}
+
+uint32_t ms_vec_env_observation_size(const MsVecEnv* env) {
+  return env->settings.cell_count();
+}
+
+uint32_t ms_vec_env_num_actions(const MsVecEnv* env) {
+  return 2 * env->settings.cell_count();
+}
+
+void ms_vec_env_reset(MsVecEnv* env, uint8_t* observations) {
+  const unsigned int cells = env->settings.cell_count();
+  for (std::size_t i = 0; i < env->boards.size(); ++i) {
+    GameBoard& board = env->boards[i];
+    board.reset(env->next_seed++);
+    write_observation(board, observations + i * cells);
+  }
+}
+
+int ms_vec_env_step(MsVecEnv* env, const int32_t* actions,
+                    uint8_t* observations, float* rewards, uint8_t* dones) {
+  const unsigned int cells = env->settings.cell_count();
+  const float safe_cells = static_cast<float>(cells - env->settings.bombs);
+  const std::size_t count = env->boards.size();
+
+  // Validate everything first so a bad batch leaves every board untouched
+  for (std::size_t i = 0; i < count; ++i) {
+    if (actions[i] < 0 || static_cast<uint32_t>(actions[i]) >= 2 * cells) {
+      return -1;
+    }
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    GameBoard& board = env->boards[i];
+    uint8_t* observation = observations + i * cells;
+    unsigned int action = static_cast<unsigned int>(actions[i]);
+    float reward = 0.0f;
+
+    if (action < cells) {
+      board.open_cell(action / board.get_columns(),
+                      action % board.get_columns());
+      write_opened_cells(board, observation);
+      if (board.get_game_state() == GameState::GameOver) {
+        reward = -1.0f;
+      } else {
+        reward = board.get_opened_count() / safe_cells;
+      }
+    } else {
+      unsigned int cell = action - cells;
+      unsigned int row = cell / board.get_columns();
+      unsigned int col = cell % board.get_columns();
+      board.toggle_flag(row, col);
+      observation[cell] = encode_cell(board.get_cell(row, col));
+    }
+
+    bool done = board.get_game_state() != GameState::Playing;
+    if (done) {
+      board.reset(env->next_seed++);
+      write_observation(board, observation);
+    }
+    rewards[i] = reward;
+    dones[i] = done ? 1 : 0;
+  }
+  return 0;
+}
+
+}  // extern "C"
@@ -0,0 +1,71 @@
+#ifndef MINESWEEPER_ENV_H_
+#define MINESWEEPER_ENV_H_
+
+/*
+ * Vectorized Minesweeper environment with a C ABI, for reinforcement learning.
+ *
+ * One environment steps N boards of the same size in lockstep. Observations
+ * are written to a caller-owned buffer of N * rows * columns bytes, one byte
+ * per cell in row-major order, board after board:
+ *
+ *   0-8   opened cell, value is the number of adjacent bombs
+ *   9     closed cell
+ *   10    closed cell with a flag
+ *   11    opened bomb (the episode ended on this cell)
+ *
+ * The buffer is updated in place: reset writes it completely, and step only
+ * rewrites the cells that changed. Pass the same buffer to every call.
+ *
+ * Action a of a board:
+ *   0 <= a < cells           open cell a (a = row * columns + column)
+ *   cells <= a < 2 * cells   toggle the flag on cell a - cells
+ *
+ * Rewards: opening safe cells gives (opened cells / safe cells), so a
+ * cleared board sums to 1. Hitting a bomb gives -1. Anything else gives 0.
+ *
+ * Bombs are placed when the first cell of an episode is opened. That cell is
+ * never a bomb, and neither are its neighbors if the board has room.
+ *
+ * A board whose episode ends is reset immediately with the next seed. Its
+ * done flag is set and its observation already shows the new board.
+ *
+ * No function allocates except ms_vec_env_create.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct MsVecEnv MsVecEnv;
+
+/* Returns NULL if the arguments don't describe a playable board, or one with
+ * 2^30 or more cells. Call ms_vec_env_reset before the first
+ * ms_vec_env_step: it starts the first episodes and writes the first
+ * observations. Board i's first episode uses seed + i; later episodes
+ * continue from seed + num_envs. */
+MsVecEnv* ms_vec_env_create(uint32_t num_envs, uint32_t rows, uint32_t columns,
+                            uint32_t bombs, uint64_t seed);
+void ms_vec_env_destroy(MsVecEnv* env);
+
+uint32_t ms_vec_env_num_envs(const MsVecEnv* env);
+/* Bytes of observation per board (rows * columns) */
+uint32_t ms_vec_env_observation_size(const MsVecEnv* env);
+/* Number of distinct actions per board (2 * rows * columns) */
+uint32_t ms_vec_env_num_actions(const MsVecEnv* env);
+
+/* Start a new episode on every board and write all observations */
+void ms_vec_env_reset(MsVecEnv* env, uint8_t* observations);
+
+/* Apply one action to every board. `actions` has num_envs entries; rewards
+ * and dones receive num_envs values each. Returns 0, or -1 (and changes
+ * nothing) if an action is out of range. */
+int ms_vec_env_step(MsVecEnv* env, const int32_t* actions,
+                    uint8_t* observations, float* rewards, uint8_t* dones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINESWEEPER_ENV_H_ */
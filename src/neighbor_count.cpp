@@ -0,0 +1,200 @@
+#include "neighbor_count.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define NEIGHBOR_COUNT_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+// SSE2 is part of the x86-64 baseline; 32-bit builds only have it if enabled
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NEIGHBOR_COUNT_SSE2 1
+#endif
+#endif
+
+// GCC and Clang only emit AVX2 instructions in functions marked for it; MSVC
+// accepts the intrinsics anywhere
+#if defined(NEIGHBOR_COUNT_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NEIGHBOR_COUNT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NEIGHBOR_COUNT_TARGET_AVX2
+#endif
+
+namespace {
+
+inline std::uint64_t load_u64(const std::uint8_t* p) {
+  std::uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+void count_range_scalar(const std::uint8_t* mask, std::uint8_t* counts,
+                        std::size_t begin, std::size_t end,
+                        std::size_t stride) {
+  for (std::size_t i = begin; i < end; ++i) {
+    const std::uint8_t* above = mask + i - stride;
+    const std::uint8_t* center = mask + i;
+    const std::uint8_t* below = mask + i + stride;
+    counts[i] = static_cast<std::uint8_t>(above[-1] + above[0] + above[1] +
+                                          center[-1] + center[1] + below[-1] +
+                                          below[0] + below[1]);
+  }
+}
+
+// SWAR: 8 cells per 64-bit add. Each byte sums to at most 8, so no carry
+// crosses into the next byte.
+void count_range_portable(const std::uint8_t* mask, std::uint8_t* counts,
+                          std::size_t begin, std::size_t end,
+                          std::size_t stride) {
+  std::size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    const std::uint8_t* above = mask + i - stride;
+    const std::uint8_t* center = mask + i;
+    const std::uint8_t* below = mask + i + stride;
+    std::uint64_t sum = load_u64(above - 1) + load_u64(above) +
+                        load_u64(above + 1) + load_u64(center - 1) +
+                        load_u64(center + 1) + load_u64(below - 1) +
+                        load_u64(below) + load_u64(below + 1);
+    std::memcpy(counts + i, &sum, sizeof(sum));
+  }
+  count_range_scalar(mask, counts, i, end, stride);
+}
+
+#ifdef NEIGHBOR_COUNT_SSE2
+
+inline __m128i load_128(const std::uint8_t* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+void count_range_sse2(const std::uint8_t* mask, std::uint8_t* counts,
+                      std::size_t begin, std::size_t end, std::size_t stride) {
+  std::size_t i = begin;
+  for (; i + 16 <= end; i += 16) {
+    const std::uint8_t* above = mask + i - stride;
+    const std::uint8_t* center = mask + i;
+    const std::uint8_t* below = mask + i + stride;
+    __m128i top = _mm_add_epi8(
+        _mm_add_epi8(load_128(above - 1), load_128(above)),
+        load_128(above + 1));
+    __m128i middle = _mm_add_epi8(load_128(center - 1), load_128(center + 1));
+    __m128i bottom = _mm_add_epi8(
+        _mm_add_epi8(load_128(below - 1), load_128(below)),
+        load_128(below + 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(counts + i),
+                     _mm_add_epi8(_mm_add_epi8(top, middle), bottom));
+  }
+  count_range_scalar(mask, counts, i, end, stride);
+}
+
+#endif  // NEIGHBOR_COUNT_SSE2
+
+#ifdef NEIGHBOR_COUNT_X86
+
+NEIGHBOR_COUNT_TARGET_AVX2
+inline __m256i load_256(const std::uint8_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+NEIGHBOR_COUNT_TARGET_AVX2
+void count_range_avx2(const std::uint8_t* mask, std::uint8_t* counts,
+                      std::size_t begin, std::size_t end, std::size_t stride) {
+  std::size_t i = begin;
+  for (; i + 32 <= end; i += 32) {
+    const std::uint8_t* above = mask + i - stride;
+    const std::uint8_t* center = mask + i;
+    const std::uint8_t* below = mask + i + stride;
+    __m256i top = _mm256_add_epi8(
+        _mm256_add_epi8(load_256(above - 1), load_256(above)),
+        load_256(above + 1));
+    __m256i middle =
+        _mm256_add_epi8(load_256(center - 1), load_256(center + 1));
+    __m256i bottom = _mm256_add_epi8(
+        _mm256_add_epi8(load_256(below - 1), load_256(below)),
+        load_256(below + 1));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(counts + i),
+                        _mm256_add_epi8(_mm256_add_epi8(top, middle), bottom));
+  }
+  count_range_scalar(mask, counts, i, end, stride);
+}
+
+bool cpu_supports_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  // The OS must save the YMM registers (OSXSAVE + XCR0 bits 1 and 2)
+  __cpuid(info, 1);
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif  // NEIGHBOR_COUNT_X86
+
+NeighborCountKernel detect_kernel() {
+#ifdef NEIGHBOR_COUNT_X86
+  if (cpu_supports_avx2()) {
+    return NeighborCountKernel::Avx2;
+  }
+#endif
+#ifdef NEIGHBOR_COUNT_SSE2
+  return NeighborCountKernel::Sse2;
+#endif
+  return NeighborCountKernel::Portable;
+}
+
+}  // namespace
+
+NeighborCountKernel active_neighbor_count_kernel() {
+  static const NeighborCountKernel kernel = detect_kernel();
+  return kernel;
+}
+
+const char* neighbor_count_kernel_name(NeighborCountKernel kernel) {
+  switch (kernel) {
+    case NeighborCountKernel::Sse2:
+      return "SSE2";
+    case NeighborCountKernel::Avx2:
+      return "AVX2";
+    default:
+      return "Portable";
+  }
+}
+
+void count_neighbors(const std::uint8_t* mask, std::uint8_t* counts,
+                     std::size_t begin, std::size_t end, std::size_t stride) {
+  count_neighbors(active_neighbor_count_kernel(), mask, counts, begin, end,
+                  stride);
+}
+
+void count_neighbors(NeighborCountKernel kernel, const std::uint8_t* mask,
+                     std::uint8_t* counts, std::size_t begin, std::size_t end,
+                     std::size_t stride) {
+  switch (kernel) {
+#ifdef NEIGHBOR_COUNT_X86
+    case NeighborCountKernel::Avx2:
+      count_range_avx2(mask, counts, begin, end, stride);
+      return;
+#endif
+#ifdef NEIGHBOR_COUNT_SSE2
+    case NeighborCountKernel::Sse2:
+      count_range_sse2(mask, counts, begin, end, stride);
+      return;
+#endif
+    default:
+      count_range_portable(mask, counts, begin, end, stride);
+      return;
+  }
+}
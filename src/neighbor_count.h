@@ -0,0 +1,34 @@
+#ifndef NEIGHBOR_COUNT_H_
+#define NEIGHBOR_COUNT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// Bulk computation of bomb counts from a bomb mask.
+//
+// The mask holds one byte per cell (0 or 1) in the padded BoardLayout, so
+// the 8 neighbors of every cell are at fixed offsets. The count of a cell is
+// then the sum of 8 shifted copies of the mask, which is computed many cells
+// at a time with SIMD. Counts are at most 8 and fit in one byte.
+
+enum class NeighborCountKernel { Portable, Sse2, Avx2 };
+
+// Kernel picked for this CPU. Detected once, on first use.
+NeighborCountKernel active_neighbor_count_kernel();
+
+// Human readable name of a kernel, for logs
+const char* neighbor_count_kernel_name(NeighborCountKernel kernel);
+
+// Write counts[i] = number of set mask bytes among the 8 neighbors of i, for
+// every i in [begin, end). `stride` is the distance between rows. All
+// neighbors of the range must be inside the mask, which holds for the
+// in-board range of a padded layout.
+void count_neighbors(const std::uint8_t* mask, std::uint8_t* counts,
+                     std::size_t begin, std::size_t end, std::size_t stride);
+
+// Same, with an explicit kernel. The kernel must be supported by the CPU.
+void count_neighbors(NeighborCountKernel kernel, const std::uint8_t* mask,
+                     std::uint8_t* counts, std::size_t begin, std::size_t end,
+                     std::size_t stride);
+
+#endif  // NEIGHBOR_COUNT_H_
@@ -1,9 +1,13 @@
 #include "renderer.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
 #include <vector>
 
 #include "game_settings.h"
+#include "shader_cache.h"
+#include "trace.h"
 
 // Vertex shader source code
 const char* vertexShaderSource = R"(
@@ -30,8 +34,193 @@ void main() {
 }
 )";
 
+// Texture mode: one instance per board, covering the board's rectangle.
+// Rectangles are in pixels from the top-left corner of the window.
+const char* boardVertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec4 aRect;     // x, y, width, height
+layout (location = 1) in vec2 aPadding;  // Gap on each side of a cell
+layout (location = 2) in ivec4 aTile;    // Atlas x, y, then columns, rows
+
+uniform vec2 viewport;  // Window size in pixels
+
+flat out vec4 rect;
+flat out vec2 padding;
+flat out ivec4 tile;
+
+const vec2 kCorners[6] = vec2[6](vec2(0.0, 0.0), vec2(1.0, 0.0),
+                                 vec2(0.0, 1.0), vec2(1.0, 0.0),
+                                 vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main() {
+    vec2 pixel = aRect.xy + kCorners[gl_VertexID] * aRect.zw;
+    gl_Position = vec4(pixel.x / viewport.x * 2.0 - 1.0,
+                       1.0 - pixel.y / viewport.y * 2.0, 0.0, 1.0);
+    rect = aRect;
+    padding = aPadding;
+    tile = aTile;
+}
+)";
+
+// Texture mode: every pixel looks up its cell in the board's atlas tile and
+// draws the cell's color, the gap around it and its number. Cell codes are
+// those of cell_code().
+const char* boardFragmentShaderSource = R"(
+#version 330 core
+out vec4 FragColor;
+
+uniform sampler2D cells;  // Atlas, one byte per cell
+uniform vec2 viewport;
+
+flat in vec4 rect;
+flat in vec2 padding;
+flat in ivec4 tile;
+
+const vec3 kBackground = vec3(0.1);
+
+// Seven-segment glyphs: bit 0 top, then clockwise, bit 6 middle. 1-8, then
+// 'b' for bombs.
+const int kSegments[10] = int[10](0, 6, 91, 79, 102, 109, 125, 7, 127, 124);
+const vec3 kGlyphColors[10] = vec3[10](
+    vec3(0.0), vec3(0.0, 0.0, 1.0), vec3(0.0, 0.5, 0.0), vec3(1.0, 0.0, 0.0),
+    vec3(0.0, 0.0, 0.5), vec3(0.5, 0.0, 0.0), vec3(0.0, 0.5, 0.5),
+    vec3(0.0), vec3(0.5), vec3(0.0));
+
+// p is inside a glyph of the given size, origin at its top-left
+bool segment_lit(int segments, vec2 p, vec2 size, float thickness) {
+    bool left = p.x < thickness;
+    bool right = p.x > size.x - thickness;
+    bool upper = p.y < size.y * 0.5;
+    return ((segments & 1) != 0 && p.y < thickness) ||
+           ((segments & 2) != 0 && right && upper) ||
+           ((segments & 4) != 0 && right && !upper) ||
+           ((segments & 8) != 0 && p.y > size.y - thickness) ||
+           ((segments & 16) != 0 && left && !upper) ||
+           ((segments & 32) != 0 && left && upper) ||
+           ((segments & 64) != 0 && abs(p.y - size.y * 0.5) < thickness * 0.5);
+}
+
+void main() {
+    // Pixel position from the top-left corner of the board
+    vec2 p = vec2(gl_FragCoord.x, viewport.y - gl_FragCoord.y) - rect.xy;
+
+    ivec2 grid = tile.zw;
+    vec2 cellSize = rect.zw / vec2(grid);
+    ivec2 cell = clamp(ivec2(p / cellSize), ivec2(0), grid - 1);
+    vec2 local = p - vec2(cell) * cellSize;
+    if (any(lessThan(local, padding)) ||
+        any(greaterThan(local, cellSize - padding))) {
+        FragColor = vec4(kBackground, 1.0);
+        return;
+    }
+
+    int code = int(texelFetch(cells, tile.xy + cell, 0).r * 255.0 + 0.5);
+    vec3 color;
+    int glyph = 0;
+    if (code == 9) {
+        color = vec3(0.3);  // Closed
+    } else if (code == 10) {
+        color = vec3(1.0, 0.6, 0.0);  // Flag
+    } else if (code == 11) {
+        color = vec3(1.0, 0.0, 0.0);  // Bomb
+        glyph = 9;
+    } else if (code == 0) {
+        color = vec3(0.9);
+    } else {
+        float intensity = float(code) / 8.0;
+        color = vec3(intensity, 1.0 - intensity, 0.3);
+        glyph = code;
+    }
+
+    // Glyph at 60% of the cell height, centered
+    if (glyph != 0) {
+        vec2 size = vec2(0.5, 1.0) * min(cellSize.y * 0.6, cellSize.x * 1.2);
+        vec2 g = local - (cellSize - size) * 0.5;
+        if (all(greaterThanEqual(g, vec2(0.0))) && all(lessThan(g, size)) &&
+            segment_lit(kSegments[glyph], g, size, size.y * 0.14)) {
+            color = kGlyphColors[glyph];
+        }
+    }
+
+    FragColor = vec4(color, 1.0);
+}
+)";
+
+namespace {
+
+// Program binaries, next to the stats file in the working directory
+const char* kShaderCacheDirectory = "minesweeper_cache";
+
+// Byte stored in the board texture for a cell: 0-8 open with that many
+// neighboring bombs, 9 closed, 10 flagged, 11 open bomb
+std::uint8_t cell_code(const Cell& cell) {
+  if (!cell.is_open()) {
+    return cell.has_flag() ? 10 : 9;
+  }
+  return cell.has_bomb() ? 11
+                         : static_cast<std::uint8_t>(cell.get_bomb_count());
+}
+
+// Gap on each side of a cell, in normalized device coordinates
+float cell_padding(Difficulty difficulty) {
+  if (difficulty == Difficulty::Easy) {
+    return 0.02f;  // Larger gap for easy mode
+  } else if (difficulty == Difficulty::Normal) {
+    return 0.01f;  // Medium gap for normal mode
+  }
+  return 0.005f;  // Smaller gap for hard mode
+}
+
+// Gap around each board in the spectator grid, in pixels
+constexpr float kBoardMargin = 4.0f;
+
+// Columns of a near-square grid holding `count` items
+unsigned int grid_columns(std::size_t count) {
+  unsigned int columns = 1;
+  while (static_cast<std::size_t>(columns) * columns < count) {
+    ++columns;
+  }
+  return columns;
+}
+
+// Arrangement of the atlas: a grid of equal slots, each big enough for the
+// largest board
+struct AtlasPlan {
+  unsigned int slot_rows;
+  unsigned int slot_columns;
+  unsigned int tiles_per_row;
+  unsigned int width;
+  unsigned int height;
+};
+
+AtlasPlan plan_atlas(const GameBoard* boards, std::size_t count) {
+  AtlasPlan plan{0, 0, grid_columns(count), 0, 0};
+  for (std::size_t i = 0; i < count; ++i) {
+    plan.slot_rows = std::max(plan.slot_rows, boards[i].get_rows());
+    plan.slot_columns = std::max(plan.slot_columns, boards[i].get_columns());
+  }
+  std::size_t tile_rows = (count + plan.tiles_per_row - 1) / plan.tiles_per_row;
+  plan.width = plan.tiles_per_row * plan.slot_columns;
+  plan.height = static_cast<unsigned int>(tile_rows) * plan.slot_rows;
+  return plan;
+}
+
+}  // namespace
+
 Renderer::Renderer(GLFWwindow* window)
-    : window_(window), shader_program_(0), vao_(0), vbo_(0) {}
+    : window_(window),
+      shader_program_(0),
+      vao_(0),
+      vbo_(0),
+      board_program_(0),
+      board_vao_(0),
+      instance_vbo_(0),
+      atlas_texture_(0),
+      viewport_location_(-1),
+      max_texture_size_(0),
+      atlas_width_(0),
+      atlas_height_(0),
+      drew_cell_labels_(false) {}
 
 Renderer::~Renderer() { cleanup(); }
 
@@ -44,56 +233,58 @@ bool Renderer::initialize() {
   glGenVertexArrays(1, &vao_);
   glGenBuffers(1, &vbo_);
 
+  // Atlas texture, sized on first use, and the per-board instance data
+  if (board_program_ != 0) {
+    glGenVertexArrays(1, &board_vao_);
+    glGenBuffers(1, &instance_vbo_);
+    glBindVertexArray(board_vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(BoardInstance),
+                          (void*)offsetof(BoardInstance, rect));
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(BoardInstance),
+                          (void*)offsetof(BoardInstance, padding));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(1);
+    glVertexAttribIPointer(2, 4, GL_INT, sizeof(BoardInstance),
+                           (void*)offsetof(BoardInstance, tile));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+
+    glGenTextures(1, &atlas_texture_);
+    glBindTexture(GL_TEXTURE_2D, atlas_texture_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size_);
+  }
+
   return true;
 }
 
 bool Renderer::setup_shaders() {
-  // Compile vertex shader
-  unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-  glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-  glCompileShader(vertexShader);
-
-  int success;
-  char infoLog[512];
-  glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-  if (!success) {
-    glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-    std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-              << infoLog << std::endl;
-    return false;
-  }
-
-  // Compile fragment shader
-  unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-  glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-  glCompileShader(fragmentShader);
-  glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-  if (!success) {
-    glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-    std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-              << infoLog << std::endl;
-    glDeleteShader(vertexShader);
+  // Linked programs are reused across launches when the driver allows
+  ShaderCache cache(kShaderCacheDirectory);
+  shader_program_ =
+      cache.get_program("quads", vertexShaderSource, fragmentShaderSource);
+  if (shader_program_ == 0) {
     return false;
   }
 
-  // Link shaders
-  shader_program_ = glCreateProgram();
-  glAttachShader(shader_program_, vertexShader);
-  glAttachShader(shader_program_, fragmentShader);
-  glLinkProgram(shader_program_);
-  glGetProgramiv(shader_program_, GL_LINK_STATUS, &success);
-  if (!success) {
-    glGetProgramInfoLog(shader_program_, 512, NULL, infoLog);
-    std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-              << infoLog << std::endl;
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    return false;
+  // Texture mode is optional; without it every frame uses the quads
+  board_program_ = cache.get_program("board", boardVertexShaderSource,
+                                     boardFragmentShaderSource);
+  if (board_program_ == 0) {
+    std::cerr << "Texture board rendering unavailable, using quads"
+              << std::endl;
+    return true;
   }
-
-  // Clean up
-  glDeleteShader(vertexShader);
-  glDeleteShader(fragmentShader);
+  glUseProgram(board_program_);
+  glUniform1i(glGetUniformLocation(board_program_, "cells"), 0);
+  viewport_location_ = glGetUniformLocation(board_program_, "viewport");
 
   return true;
 }
@@ -140,7 +331,8 @@ void Renderer::get_cell_color(const Cell& cell, float& r, float& g,
   }
 }
 
-void Renderer::render(const GameBoard& board) {
+void Renderer::render(const GameBoard& board, const ViewOptions& view) {
+  TRACE_SCOPE("Renderer::render");
   // Clear screen
   glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
   glClear(GL_COLOR_BUFFER_BIT);
@@ -149,31 +341,82 @@ void Renderer::render(const GameBoard& board) {
   int display_w, display_h;
   glfwGetFramebufferSize(window_, &display_w, &display_h);
 
-  // Calculate the vertical offset in normalized coordinates
-  // The game board should start below the console bar
-  float console_height_ndc = (UIConfig::kConsoleBarHeight / display_h) *
-                             2.0f;  // Convert to NDC (-1 to 1 range)
-  float board_vertical_size =
-      2.0f - console_height_ndc;  // Remaining vertical space for board
+  // The board fills the window below the console bar
+  BoardRect rect{0.0f, UIConfig::kConsoleBarHeight, (float)display_w,
+                 display_h - UIConfig::kConsoleBarHeight};
+  draw_boards(&board, &rect, 1, view.gpu_board, display_w, display_h);
+}
+
+void Renderer::render_boards(const std::vector<GameBoard>& boards) {
+  TRACE_SCOPE("Renderer::render_boards");
+  glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT);
+  if (boards.empty()) {
+    drew_cell_labels_ = false;
+    return;
+  }
+
+  int display_w, display_h;
+  glfwGetFramebufferSize(window_, &display_w, &display_h);
+
+  // Near-square grid below the console bar, with a margin around each board
+  unsigned int columns = grid_columns(boards.size());
+  unsigned int rows =
+      static_cast<unsigned int>((boards.size() + columns - 1) / columns);
+  float slot_width = (float)display_w / columns;
+  float slot_height = (display_h - UIConfig::kConsoleBarHeight) / rows;
+  board_rects_.resize(boards.size());
+  for (std::size_t i = 0; i < boards.size(); ++i) {
+    unsigned int column = static_cast<unsigned int>(i % columns);
+    unsigned int row = static_cast<unsigned int>(i / columns);
+    board_rects_[i] = BoardRect{
+        column * slot_width + kBoardMargin,
+        UIConfig::kConsoleBarHeight + row * slot_height + kBoardMargin,
+        slot_width - 2 * kBoardMargin, slot_height - 2 * kBoardMargin};
+  }
+  draw_boards(boards.data(), board_rects_.data(), boards.size(), true,
+              display_w, display_h);
+}
 
-  // Generate vertices for all cells
-  std::vector<float> vertices;
+void Renderer::draw_boards(const GameBoard* boards, const BoardRect* rects,
+                           std::size_t count, bool use_texture, int display_w,
+                           int display_h) {
+  // Atlases wider or taller than the GPU's texture limit fall back to quads
+  AtlasPlan plan = plan_atlas(boards, count);
+  unsigned int max_size = static_cast<unsigned int>(max_texture_size_);
+  drew_cell_labels_ = use_texture && board_program_ != 0 &&
+                      plan.width <= max_size && plan.height <= max_size;
+  if (drew_cell_labels_) {
+    render_texture(boards, rects, count, display_w, display_h);
+    return;
+  }
+
+  // Generate vertices for all cells, reusing last frame's buffer
+  vertices_.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    append_quads(boards[i], rects[i], display_w, display_h);
+  }
+  draw_quads();
+}
+
+void Renderer::append_quads(const GameBoard& board, const BoardRect& rect,
+                            int display_w, int display_h) {
+  // Board rectangle in normalized device coordinates (-1 to 1)
+  float left = rect.x / display_w * 2.0f - 1.0f;
+  float top = 1.0f - rect.y / display_h * 2.0f;
+  float bottom = 1.0f - (rect.y + rect.height) / display_h * 2.0f;
+  float width = rect.width / display_w * 2.0f;
+
+  std::vector<float>& vertices = vertices_;
   unsigned int rows = board.get_rows();
   unsigned int cols = board.get_columns();
 
-  float cell_width = 2.0f / cols;  // Normalized device coordinates (-1 to 1)
-  float cell_height =
-      board_vertical_size / rows;  // Use only the remaining vertical space
+  float cell_width = width / cols;
+  float cell_height = (top - bottom) / rows;
 
-  Difficulty difficulty = board.get_difficulty();
-  float padding;
-  if (difficulty == Difficulty::Easy) {
-    padding = 0.02f;  // Larger gap for easy mode
-  } else if (difficulty == Difficulty::Normal) {
-    padding = 0.01f;  // Medium gap for normal mode
-  } else {
-    padding = 0.005f;  // Smaller gap for hard mode
-  }
+  // The gap shrinks with the board
+  float padding =
+      cell_padding(board.get_difficulty()) * (rect.width / display_w);
 
   for (unsigned int row = 0; row < rows; ++row) {
     for (unsigned int col = 0; col < cols; ++col) {
@@ -184,9 +427,8 @@ void Renderer::render(const GameBoard& board) {
       get_cell_color(cell, r, g, b);
 
       // Calculate cell position (top-left origin, y increases downward)
-      // Start from below the console bar (1.0 - console_height_ndc)
-      float x1 = -1.0f + col * cell_width + padding;
-      float y1 = 1.0f - console_height_ndc - row * cell_height - padding;
+      float x1 = left + col * cell_width + padding;
+      float y1 = top - row * cell_height - padding;
       float x2 = x1 + cell_width - 2 * padding;
       float y2 = y1 - cell_height + 2 * padding;
 
@@ -232,6 +474,10 @@ void Renderer::render(const GameBoard& board) {
       vertices.push_back(b);
     }
   }
+}
+
+void Renderer::draw_quads() {
+  std::vector<float>& vertices = vertices_;
 
   // Upload vertex data
   glBindVertexArray(vao_);
@@ -254,6 +500,129 @@ void Renderer::render(const GameBoard& board) {
   glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 5);
 }
 
+void Renderer::render_texture(const GameBoard* boards, const BoardRect* rects,
+                              std::size_t count, int display_w,
+                              int display_h) {
+  update_atlas(boards, count);
+
+  // Same layout as the quads: padding given in NDC, scaled with the board
+  // and converted to pixels per axis
+  instances_.resize(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const AtlasTile& tile = atlas_tiles_[i];
+    float padding = cell_padding(boards[i].get_difficulty()) *
+                    (rects[i].width / display_w);
+    instances_[i] = BoardInstance{
+        rects[i],
+        {padding * display_w / 2.0f, padding * display_h / 2.0f},
+        {(std::int32_t)tile.x, (std::int32_t)tile.y,
+         (std::int32_t)tile.columns, (std::int32_t)tile.rows}};
+  }
+
+  glUseProgram(board_program_);
+  glUniform2f(viewport_location_, (float)display_w, (float)display_h);
+
+  glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+  glBufferData(GL_ARRAY_BUFFER, instances_.size() * sizeof(BoardInstance),
+               instances_.data(), GL_STREAM_DRAW);
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, atlas_texture_);
+  glBindVertexArray(board_vao_);
+  glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(count));
+}
+
+void Renderer::update_atlas(const GameBoard* boards, std::size_t count) {
+  AtlasPlan plan = plan_atlas(boards, count);
+
+  glBindTexture(GL_TEXTURE_2D, atlas_texture_);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  bool relayout = plan.width != atlas_width_ ||
+                  plan.height != atlas_height_ ||
+                  count != atlas_tiles_.size();
+  for (std::size_t i = 0; i < count && !relayout; ++i) {
+    relayout = boards[i].get_rows() != atlas_tiles_[i].rows ||
+               boards[i].get_columns() != atlas_tiles_[i].columns;
+  }
+
+  // New arrangement: reallocate the texture and upload every cell
+  if (relayout) {
+    cell_codes_.assign(static_cast<std::size_t>(plan.width) * plan.height, 0);
+    atlas_tiles_.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      const GameBoard& board = boards[i];
+      AtlasTile& tile = atlas_tiles_[i];
+      tile.x = static_cast<unsigned int>(i % plan.tiles_per_row) *
+               plan.slot_columns;
+      tile.y =
+          static_cast<unsigned int>(i / plan.tiles_per_row) * plan.slot_rows;
+      tile.rows = board.get_rows();
+      tile.columns = board.get_columns();
+      tile.revision = board.get_revision();
+      for (unsigned int row = 0; row < tile.rows; ++row) {
+        std::uint8_t* codes = cell_codes_.data() +
+                              static_cast<std::size_t>(tile.y + row) *
+                                  plan.width +
+                              tile.x;
+        for (unsigned int col = 0; col < tile.columns; ++col) {
+          codes[col] = cell_code(board.get_cell(row, col));
+        }
+      }
+    }
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, plan.width, plan.height, 0, GL_RED,
+                 GL_UNSIGNED_BYTE, cell_codes_.data());
+    atlas_width_ = plan.width;
+    atlas_height_ = plan.height;
+    return;
+  }
+
+  // Refresh the rows changed since the last upload (see
+  // GameBoard::get_row_revision()), so a click costs its rows rather than
+  // the whole board; only a reset refreshes every row. Then upload the span
+  // of atlas rows that differ.
+  unsigned int first_dirty = atlas_height_;
+  unsigned int last_dirty = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    const GameBoard& board = boards[i];
+    AtlasTile& tile = atlas_tiles_[i];
+    if (board.get_revision() == tile.revision) {
+      continue;  // Nothing changed since the last upload
+    }
+    // An older revision means another board took the tile
+    const bool every_row = board.get_revision() < tile.revision;
+    for (unsigned int row = 0; row < tile.rows; ++row) {
+      if (!every_row && board.get_row_revision(row) <= tile.revision) {
+        continue;
+      }
+      unsigned int atlas_row = tile.y + row;
+      std::uint8_t* codes = cell_codes_.data() +
+                            static_cast<std::size_t>(atlas_row) *
+                                atlas_width_ +
+                            tile.x;
+      bool dirty = false;
+      for (unsigned int col = 0; col < tile.columns; ++col) {
+        std::uint8_t code = cell_code(board.get_cell(row, col));
+        if (codes[col] != code) {
+          codes[col] = code;
+          dirty = true;
+        }
+      }
+      if (dirty) {
+        first_dirty = std::min(first_dirty, atlas_row);
+        last_dirty = std::max(last_dirty, atlas_row);
+      }
+    }
+    tile.revision = board.get_revision();
+  }
+  if (first_dirty < atlas_height_) {
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first_dirty, atlas_width_,
+                    last_dirty - first_dirty + 1, GL_RED, GL_UNSIGNED_BYTE,
+                    cell_codes_.data() +
+                        static_cast<std::size_t>(first_dirty) * atlas_width_);
+  }
+}
+
 void Renderer::cleanup() {
   if (vao_ != 0) {
     glDeleteVertexArrays(1, &vao_);
@@ -267,4 +636,23 @@ void Renderer::cleanup() {
     glDeleteProgram(shader_program_);
     shader_program_ = 0;
   }
+  if (board_vao_ != 0) {
+    glDeleteVertexArrays(1, &board_vao_);
+    board_vao_ = 0;
+  }
+  if (instance_vbo_ != 0) {
+    glDeleteBuffers(1, &instance_vbo_);
+    instance_vbo_ = 0;
+  }
+  if (atlas_texture_ != 0) {
+    glDeleteTextures(1, &atlas_texture_);
+    atlas_texture_ = 0;
+  }
+  if (board_program_ != 0) {
+    glDeleteProgram(board_program_);
+    board_program_ = 0;
+  }
+  atlas_tiles_.clear();
+  atlas_width_ = 0;
+  atlas_height_ = 0;
 }
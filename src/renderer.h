@@ -4,7 +4,12 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <cstdint>
+#include <vector>
+
 #include "game_board.h"
+#include "game_settings.h"
+#include "view_options.h"
 
 class Renderer {
  public:
@@ -15,20 +20,86 @@ class Renderer {
   bool initialize();
 
   // Render the game board
-  void render(const GameBoard& board);
+  void render(const GameBoard& board, const ViewOptions& view);
+
+  // Render many boards side by side for the spectator view, filling the
+  // window below the console bar. In texture mode all boards go out in one
+  // instanced draw call.
+  void render_boards(const std::vector<GameBoard>& boards);
+
+  // True if the last render() or render_boards() drew the cell numbers
+  // itself, so the UI shouldn't draw them again
+  bool draws_cell_labels() const { return drew_cell_labels_; }
+
+  // Where the last render_boards() drew each board
+  const std::vector<BoardRect>& board_rects() const { return board_rects_; }
 
   // Cleanup OpenGL resources
   void cleanup();
 
  private:
+  // Per-instance attributes of the texture mode draw
+  struct BoardInstance {
+    BoardRect rect;
+    float padding[2];  // Gap on each side of a cell, in pixels
+    std::int32_t tile[4];  // Atlas x, y, then columns, rows
+  };
+
+  // A board's tile in the atlas
+  struct AtlasTile {
+    unsigned int x;
+    unsigned int y;
+    unsigned int rows;
+    unsigned int columns;
+    std::uint64_t revision;  // Board revision last uploaded
+  };
+
   GLFWwindow* window_;
   unsigned int shader_program_;
   unsigned int vao_;
   unsigned int vbo_;
+  // Quad vertices, kept between frames so drawing doesn't allocate
+  std::vector<float> vertices_;
+  std::vector<BoardRect> board_rects_;
+
+  // Texture mode: every board is a tile of one atlas texture and an instance
+  // of one draw call
+  unsigned int board_program_;
+  unsigned int board_vao_;
+  unsigned int instance_vbo_;
+  unsigned int atlas_texture_;
+  int viewport_location_;
+  int max_texture_size_;
+  std::vector<BoardInstance> instances_;
+  // CPU copy of the atlas, one byte per cell, to find the rows to upload
+  std::vector<std::uint8_t> cell_codes_;
+  std::vector<AtlasTile> atlas_tiles_;
+  unsigned int atlas_width_;
+  unsigned int atlas_height_;
+  bool drew_cell_labels_;
 
   // Compile and link shaders
   bool setup_shaders();
 
+  // Draw each board into its rectangle, in texture mode if allowed and the
+  // atlas fits on the GPU, otherwise as quads
+  void draw_boards(const GameBoard* boards, const BoardRect* rects,
+                   std::size_t count, bool use_texture, int display_w,
+                   int display_h);
+
+  // One colored quad per cell, for all boards in one buffer
+  void append_quads(const GameBoard& board, const BoardRect& rect,
+                    int display_w, int display_h);
+  void draw_quads();
+
+  // Cell colors, padding and numbers computed per pixel from the atlas
+  void render_texture(const GameBoard* boards, const BoardRect* rects,
+                      std::size_t count, int display_w, int display_h);
+
+  // Bring the atlas up to date with the boards, re-encoding only the rows
+  // changed since the last upload
+  void update_atlas(const GameBoard* boards, std::size_t count);
+
   // Get color based on cell state
   void get_cell_color(const Cell& cell, float& r, float& g, float& b) const;
 };
@@ -0,0 +1,230 @@
+#include "shader_cache.h"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Cache file header, followed by the binary itself. Written in native byte
+// order: the cache is only valid on the machine that wrote it anyway.
+struct CacheHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint64_t key;
+  std::uint32_t binary_format;
+  std::uint32_t binary_length;
+};
+
+constexpr char kMagic[4] = {'M', 'S', 'P', 'B'};
+constexpr std::uint32_t kVersion = 1;
+
+// FNV-1a, continued from `hash`
+std::uint64_t hash_string(std::uint64_t hash, const char* text) {
+  for (; text && *text; ++text) {
+    hash ^= static_cast<unsigned char>(*text);
+    hash *= 0x100000001B3ull;
+  }
+  // Separator, so ("ab", "c") and ("a", "bc") differ
+  hash ^= 0xFF;
+  hash *= 0x100000001B3ull;
+  return hash;
+}
+
+// A binary only loads on the driver that produced it
+std::uint64_t cache_key(const char* vertex_source,
+                        const char* fragment_source) {
+  std::uint64_t hash = 0xCBF29CE484222325ull;
+  hash = hash_string(hash, vertex_source);
+  hash = hash_string(hash, fragment_source);
+  for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+    hash = hash_string(hash,
+                       reinterpret_cast<const char*>(glGetString(name)));
+  }
+  return hash;
+}
+
+bool program_binaries_supported() {
+  if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) {
+    return false;
+  }
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  return formats > 0;
+}
+
+// Compile and link a program from GLSL sources. Returns 0 on failure; the
+// compiler or linker log goes to stderr. `retrievable` asks the driver to
+// keep the binary for the cache.
+unsigned int build_program(const char* vertex_source,
+                           const char* fragment_source, bool retrievable) {
+  // Compile vertex shader
+  unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
+  glShaderSource(vertexShader, 1, &vertex_source, NULL);
+  glCompileShader(vertexShader);
+
+  int success;
+  char infoLog[512];
+  glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+  if (!success) {
+    glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+    std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
+              << infoLog << std::endl;
+    return 0;
+  }
+
+  // Compile fragment shader
+  unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+  glShaderSource(fragmentShader, 1, &fragment_source, NULL);
+  glCompileShader(fragmentShader);
+  glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+  if (!success) {
+    glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+    std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
+              << infoLog << std::endl;
+    glDeleteShader(vertexShader);
+    return 0;
+  }
+
+  // Link shaders
+  unsigned int program = glCreateProgram();
+  glAttachShader(program, vertexShader);
+  glAttachShader(program, fragmentShader);
+  if (retrievable) {
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+  glLinkProgram(program);
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (!success) {
+    glGetProgramInfoLog(program, 512, NULL, infoLog);
+    std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
+              << infoLog << std::endl;
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    glDeleteProgram(program);
+    return 0;
+  }
+
+  // Clean up
+  glDeleteShader(vertexShader);
+  glDeleteShader(fragmentShader);
+
+  return program;
+}
+
+}  // namespace
+
+ShaderCache::ShaderCache(std::string directory)
+    : directory_(std::move(directory)) {}
+
+unsigned int ShaderCache::get_program(const std::string& name,
+                                      const char* vertex_source,
+                                      const char* fragment_source) {
+  if (directory_.empty() || !program_binaries_supported()) {
+    return build_program(vertex_source, fragment_source, false);
+  }
+
+  std::string path = path_for(name);
+  std::uint64_t key = cache_key(vertex_source, fragment_source);
+  if (unsigned int program = load(path, key)) {
+    return program;
+  }
+
+  // Missing or stale: build from source and replace the cache file
+  unsigned int program = build_program(vertex_source, fragment_source, true);
+  if (program != 0) {
+    store(path, key, program);
+  }
+  return program;
+}
+
+std::string ShaderCache::path_for(const std::string& name) const {
+  return (std::filesystem::path(directory_) / (name + ".bin")).string();
+}
+
+unsigned int ShaderCache::load(const std::string& path, std::uint64_t key) {
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (!file) {
+    return 0;
+  }
+  // The binary must fill the rest of the file exactly; a truncated or
+  // corrupted length would otherwise size the read buffer
+  std::error_code error;
+  std::uintmax_t file_size = std::filesystem::file_size(path, error);
+  CacheHeader header;
+  std::vector<char> binary;
+  bool valid = !error && std::fread(&header, sizeof(header), 1, file) == 1 &&
+               std::equal(kMagic, kMagic + 4, header.magic) &&
+               header.version == kVersion && header.key == key &&
+               header.binary_length > 0 &&
+               header.binary_length <= static_cast<std::uint32_t>(
+                   std::numeric_limits<GLsizei>::max()) &&
+               header.binary_length == file_size - sizeof(header);
+  if (valid) {
+    binary.resize(header.binary_length);
+    valid = std::fread(binary.data(), 1, binary.size(), file) == binary.size();
+  }
+  std::fclose(file);
+  if (!valid) {
+    return 0;
+  }
+
+  // The driver may still reject it, e.g. after an update that kept the
+  // version string
+  unsigned int program = glCreateProgram();
+  glProgramBinary(program, header.binary_format, binary.data(),
+                  static_cast<GLsizei>(binary.size()));
+  int success;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (!success) {
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+void ShaderCache::store(const std::string& path, std::uint64_t key,
+                        unsigned int program) {
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+  std::vector<char> binary(length);
+  GLenum format = 0;
+  glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+
+  // Write a temporary file and rename it over the old one, so a crash never
+  // leaves a truncated cache file behind
+  std::string temporary = path + ".tmp";
+  std::FILE* file = std::fopen(temporary.c_str(), "wb");
+  if (!file) {
+    return;  // Caching is best effort
+  }
+  CacheHeader header;
+  std::copy(kMagic, kMagic + 4, header.magic);
+  header.version = kVersion;
+  header.key = key;
+  header.binary_format = format;
+  header.binary_length = static_cast<std::uint32_t>(length);
+  bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 std::fwrite(binary.data(), 1, binary.size(), file) ==
+                     binary.size();
+  written = std::fclose(file) == 0 && written;
+  if (written) {
+    std::filesystem::rename(temporary, path, error);
+  }
+  if (!written || error) {
+    std::filesystem::remove(temporary, error);
+  }
+}
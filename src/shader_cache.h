@@ -0,0 +1,31 @@
+#ifndef SHADER_CACHE_H_
+#define SHADER_CACHE_H_
+
+#include <cstdint>
+#include <string>
+
+// Keeps linked programs on disk as program binaries (GL 4.1 or
+// ARB_get_program_binary), so later launches skip compiling GLSL.
+//
+// A cache file is keyed on the shader sources and the GL vendor, renderer and
+// version strings. A missing, stale or rejected binary falls back to
+// compiling from source, and the new binary replaces it.
+class ShaderCache {
+ public:
+  // Cache files live in `directory`, created on first write
+  explicit ShaderCache(std::string directory);
+
+  // Linked program for the sources. Requires a current GL context. Returns 0
+  // if the sources fail to build.
+  unsigned int get_program(const std::string& name, const char* vertex_source,
+                           const char* fragment_source);
+
+ private:
+  std::string directory_;
+
+  std::string path_for(const std::string& name) const;
+  unsigned int load(const std::string& path, std::uint64_t key);
+  void store(const std::string& path, std::uint64_t key, unsigned int program);
+};
+
+#endif  // SHADER_CACHE_H_
@@ -0,0 +1,192 @@
+#include "stats_store.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+namespace {
+
+// File header: magic plus format version
+constexpr unsigned char kMagic[4] = {'M', 'S', 'S', 'T'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 8;
+
+// Record: finished_at (i64), duration_us (u64), difficulty (u8),
+// cleared (u8), 6 bytes of padding. Little-endian regardless of the host.
+constexpr std::size_t kRecordSize = 24;
+
+void put_u64(unsigned char* out, std::uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    out[i] = static_cast<unsigned char>(value >> (8 * i));
+  }
+}
+
+std::uint64_t get_u64(const unsigned char* in) {
+  std::uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+  }
+  return value;
+}
+
+void encode_header(unsigned char* out) {
+  std::copy(kMagic, kMagic + 4, out);
+  for (int i = 0; i < 4; ++i) {
+    out[4 + i] = static_cast<unsigned char>(kVersion >> (8 * i));
+  }
+}
+
+void encode_record(const GameResult& result, unsigned char* out) {
+  std::fill(out, out + kRecordSize, 0);
+  put_u64(out, static_cast<std::uint64_t>(result.finished_at));
+  put_u64(out + 8, result.duration_us);
+  out[16] = static_cast<unsigned char>(result.difficulty);
+  out[17] = result.cleared ? 1 : 0;
+}
+
+bool decode_record(const unsigned char* in, GameResult& result) {
+  if (in[16] > static_cast<unsigned char>(Difficulty::Custom) || in[17] > 1) {
+    return false;
+  }
+  result.finished_at = static_cast<std::int64_t>(get_u64(in));
+  result.duration_us = get_u64(in + 8);
+  result.difficulty = static_cast<Difficulty>(in[16]);
+  result.cleared = in[17] != 0;
+  return true;
+}
+
+}  // namespace
+
+StatsStore::~StatsStore() {
+  if (file_) {
+    std::fclose(file_);
+  }
+}
+
+bool StatsStore::open(const std::string& path) {
+  if (file_) {
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+  index_ = {};
+
+  // Replay the existing log into the index
+  std::uintmax_t valid_size = 0;
+  if (std::FILE* in = std::fopen(path.c_str(), "rb")) {
+    unsigned char header[kHeaderSize];
+    std::size_t header_read = std::fread(header, 1, kHeaderSize, in);
+    if (header_read == kHeaderSize) {
+      unsigned char expected[kHeaderSize];
+      encode_header(expected);
+      if (!std::equal(header, header + kHeaderSize, expected)) {
+        std::fclose(in);
+        std::cerr << "Unrecognized stats file: " << path << std::endl;
+        return false;  // Not ours; leave it alone
+      }
+      valid_size = kHeaderSize;
+
+      // Read in chunks of whole records
+      std::vector<unsigned char> buffer(kRecordSize * 4096);
+      std::size_t read;
+      while ((read = std::fread(buffer.data(), 1, buffer.size(), in)) > 0) {
+        std::size_t records = read / kRecordSize;
+        for (std::size_t i = 0; i < records; ++i) {
+          GameResult result;
+          if (decode_record(buffer.data() + i * kRecordSize, result)) {
+            add_to_index(result, false);
+          }
+        }
+        valid_size += records * kRecordSize;
+        if (read % kRecordSize != 0) {
+          break;  // Trailing partial record from an interrupted write
+        }
+      }
+    }
+    std::fclose(in);
+
+    // One sort per difficulty instead of a sorted insert per record
+    for (DifficultyIndex& index : index_) {
+      std::sort(index.clear_times_us.begin(), index.clear_times_us.end());
+    }
+  }
+
+  // Drop a partial record (or header) so appends stay aligned
+  std::error_code error;
+  if (std::filesystem::exists(path, error) &&
+      std::filesystem::file_size(path, error) != valid_size) {
+    std::filesystem::resize_file(path, valid_size, error);
+    if (error) {
+      std::cerr << "Failed to repair stats file: " << path << std::endl;
+      return false;
+    }
+  }
+
+  file_ = std::fopen(path.c_str(), "ab");
+  if (!file_) {
+    std::cerr << "Failed to open stats file: " << path << std::endl;
+    return false;
+  }
+  if (valid_size == 0) {
+    unsigned char header[kHeaderSize];
+    encode_header(header);
+    std::fwrite(header, 1, kHeaderSize, file_);
+    std::fflush(file_);
+  }
+  return true;
+}
+
+void StatsStore::append(const GameResult& result) {
+  add_to_index(result, true);
+  if (file_) {
+    unsigned char record[kRecordSize];
+    encode_record(result, record);
+    std::fwrite(record, 1, kRecordSize, file_);
+    std::fflush(file_);
+  }
+}
+
+unsigned int StatsStore::games_played(Difficulty difficulty) const {
+  return index_for(difficulty).played;
+}
+
+unsigned int StatsStore::games_won(Difficulty difficulty) const {
+  return static_cast<unsigned int>(
+      index_for(difficulty).clear_times_us.size());
+}
+
+std::uint64_t StatsStore::best_time_us(Difficulty difficulty) const {
+  const auto& times = index_for(difficulty).clear_times_us;
+  return times.empty() ? 0 : times.front();
+}
+
+std::uint64_t StatsStore::percentile_us(Difficulty difficulty,
+                                        double fraction) const {
+  const auto& times = index_for(difficulty).clear_times_us;
+  if (times.empty()) {
+    return 0;
+  }
+  fraction = std::clamp(fraction, 0.0, 1.0);
+  std::size_t rank = static_cast<std::size_t>(
+      std::ceil(fraction * static_cast<double>(times.size())));
+  return times[rank == 0 ? 0 : rank - 1];
+}
+
+void StatsStore::add_to_index(const GameResult& result, bool keep_sorted) {
+  DifficultyIndex& index = index_[static_cast<std::size_t>(result.difficulty)];
+  ++index.played;
+  if (!result.cleared) {
+    return;
+  }
+  auto& times = index.clear_times_us;
+  auto position = keep_sorted ? std::upper_bound(times.begin(), times.end(),
+                                                 result.duration_us)
+                              : times.end();
+  times.insert(position, result.duration_us);
+}
+
+const StatsStore::DifficultyIndex& StatsStore::index_for(
+    Difficulty difficulty) const {
+  return index_[static_cast<std::size_t>(difficulty)];
+}
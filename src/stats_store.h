@@ -0,0 +1,72 @@
+#ifndef STATS_STORE_H_
+#define STATS_STORE_H_
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "game_settings.h"
+
+// Outcome of one finished game
+struct GameResult {
+  Difficulty difficulty;
+  bool cleared;
+  // Time from the first opened cell to the end of the game
+  std::uint64_t duration_us;
+  // Wall-clock end time, seconds since the Unix epoch
+  std::int64_t finished_at;
+};
+
+// Persistent game statistics.
+//
+// Results are appended to a binary log of fixed-size records and never
+// rewritten, so a crash can at worst lose the last partial record. On open
+// the log is replayed into an in-memory index: the sorted clear times of
+// each difficulty. Best time and percentile queries are O(1) lookups into
+// that index; appending is one write plus a sorted insert.
+class StatsStore {
+ public:
+  StatsStore() = default;
+  ~StatsStore();
+
+  StatsStore(const StatsStore&) = delete;
+  StatsStore& operator=(const StatsStore&) = delete;
+
+  // Loads the log at path, creating it if needed, and keeps it open for
+  // appending. Returns false if the file can't be used; the store then keeps
+  // results in memory only.
+  bool open(const std::string& path);
+
+  // Records a result and appends it to the log
+  void append(const GameResult& result);
+
+  unsigned int games_played(Difficulty difficulty) const;
+  unsigned int games_won(Difficulty difficulty) const;
+
+  // Fastest clear in microseconds, 0 if there is none yet
+  std::uint64_t best_time_us(Difficulty difficulty) const;
+
+  // Nearest-rank percentile of clear times, fraction in [0, 1]. 0 if there
+  // are no clears yet.
+  std::uint64_t percentile_us(Difficulty difficulty, double fraction) const;
+
+ private:
+  static constexpr std::size_t kDifficultyCount = 4;
+
+  struct DifficultyIndex {
+    unsigned int played = 0;
+    // Clear times in microseconds, ascending
+    std::vector<std::uint64_t> clear_times_us;
+  };
+
+  std::array<DifficultyIndex, kDifficultyCount> index_;
+  std::FILE* file_ = nullptr;
+
+  // Without keep_sorted the clear times must be sorted afterwards
+  void add_to_index(const GameResult& result, bool keep_sorted);
+  const DifficultyIndex& index_for(Difficulty difficulty) const;
+};
+
+#endif  // STATS_STORE_H_
@@ -0,0 +1,125 @@
+// Steady-state play must not touch the heap (see alloc_tracker.h). The
+// allocation hooks are linked into this test, so the counters are live.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+#include "alloc_tracker.h"
+#include "game_board.h"
+#include "game_simulation.h"
+#include "hint_engine.h"
+
+namespace {
+
+// Allocations on every thread since `before`
+std::uint64_t allocations_since(const AllocSnapshot& before) {
+  return alloc_difference(alloc_snapshot(), before).total().allocations;
+}
+
+// Open the first closed safe cell. Returns false once none is left.
+bool open_safe_cell(GameBoard& board) {
+  for (unsigned int row = 0; row < board.get_rows(); ++row) {
+    for (unsigned int col = 0; col < board.get_columns(); ++col) {
+      const Cell& cell = board.get_cell(row, col);
+      if (!cell.is_open() && !cell.has_bomb()) {
+        board.open_cell(row, col);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// One game: a first click, a flag, then safe cells until cleared
+void play_game(GameBoard& board, std::uint64_t seed) {
+  board.reset(seed);
+  board.open_cell(board.get_rows() / 2, board.get_columns() / 2);
+  board.toggle_flag(0, 0);
+  board.toggle_flag(0, 0);
+  while (board.get_game_state() == GameState::Playing &&
+         open_safe_cell(board)) {
+  }
+}
+
+}  // namespace
+
+TEST(AllocationTest, GameBoardSteadyState) {
+  GameBoard board;
+  board.change_difficulty(Difficulty::Hard);
+  play_game(board, 1);
+
+  const AllocSnapshot before = alloc_snapshot();
+  for (std::uint64_t seed = 2; seed < 50; ++seed) {
+    play_game(board, seed);
+  }
+  board.reset();
+  board.open_cell(0, 0);
+  EXPECT_EQ(allocations_since(before), 0u);
+}
+
+TEST(AllocationTest, SimulationPublish) {
+  GameSimulation simulation;
+  simulation.start();
+
+  // Reset, click, flag another cell and wait until the logic thread
+  // publishes the clicked board
+  std::uint64_t revision = simulation.latest_board().get_revision();
+  auto play = [&](unsigned int row, unsigned int column) {
+    simulation.push_input(InputEvent::reset());
+    simulation.push_input(InputEvent::open_cell(row, column));
+    simulation.push_input(InputEvent::toggle_flag((row + 1) % 13, column));
+    while (true) {
+      const GameBoard& board = simulation.latest_board();
+      if (board.get_revision() != revision && board.is_generated()) {
+        revision = board.get_revision();
+        return;
+      }
+      std::this_thread::yield();
+    }
+  };
+  // Warm every buffer of the triple buffer
+  for (unsigned int i = 0; i < 6; ++i) {
+    play(i % 13, i % 13);
+  }
+
+  const AllocSnapshot before = alloc_snapshot();
+  for (unsigned int i = 0; i < 50; ++i) {
+    play((i * 7) % 13, (i * 5) % 13);
+  }
+  const std::uint64_t allocations = allocations_since(before);
+  simulation.stop();
+  EXPECT_EQ(allocations, 0u);
+}
+
+TEST(AllocationTest, HintRequest) {
+  HintEngine engine;
+  engine.start();
+  GameBoard board;
+
+  // Request a hint for every position of a game and wait for each
+  auto analyze_game = [&](std::uint64_t seed) {
+    board.reset(seed);
+    board.open_cell(board.get_rows() / 2, board.get_columns() / 2);
+    while (true) {
+      engine.request(board);
+      while (engine.latest().revision != board.get_revision()) {
+        std::this_thread::yield();
+      }
+      if (board.get_game_state() != GameState::Playing ||
+          !open_safe_cell(board)) {
+        break;
+      }
+    }
+  };
+  analyze_game(1);
+
+  const AllocSnapshot before = alloc_snapshot();
+  for (std::uint64_t seed = 2; seed < 20; ++seed) {
+    analyze_game(seed);
+  }
+  const std::uint64_t allocations = allocations_since(before);
+  engine.stop();
+  EXPECT_EQ(allocations, 0u);
+}
@@ -0,0 +1,225 @@
+// Board corpus: boards written with CorpusWriter read back the same, one at
+// a time and in parallel, and damaged files are rejected.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "board_corpus.h"
+#include "game_board.h"
+
+namespace {
+
+// A board as written: its seed, bombs and labels
+struct Expected {
+  std::uint64_t seed;
+  std::vector<std::uint8_t> bits;
+  BoardLabels labels;
+};
+
+std::string corpus_path(const char* name) {
+  return (std::filesystem::temp_directory_path() /
+          (std::string("minesweeper_test_") + name + ".msbc"))
+      .string();
+}
+
+std::vector<std::uint8_t> bombs_of(const GameBoard& board) {
+  std::vector<std::uint8_t> bits(
+      (board.get_rows() * board.get_columns() + 7) / 8);
+  board.store_bombs(bits.data());
+  return bits;
+}
+
+bool same_labels(const BoardLabels& a, const BoardLabels& b) {
+  return a.bbbv == b.bbbv && a.openings == b.openings &&
+         a.islands == b.islands && a.largest_opening == b.largest_opening;
+}
+
+// Write `count` generated boards, through append(board) with labels or
+// append(bits) without
+std::vector<Expected> write_corpus(const std::string& path,
+                                   const GameSettings& settings, bool labels,
+                                   unsigned int boards_per_block,
+                                   unsigned int count) {
+  std::vector<Expected> written;
+  CorpusWriter writer;
+  EXPECT_TRUE(writer.open(path, settings, labels, boards_per_block));
+  GameBoard board;
+  board.change_settings(settings);
+  for (unsigned int i = 0; i < count; ++i) {
+    board.reset(1000 + i);
+    board.generate();
+    Expected expected{board.get_seed(), bombs_of(board), BoardLabels{}};
+    if (labels) {
+      expected.labels = BoardLabels{i, 2 * i + 1, 3 * i + 2, 4 * i + 3};
+      EXPECT_TRUE(writer.append(board, &expected.labels));
+    } else {
+      EXPECT_TRUE(writer.append(expected.bits.data(), expected.seed, nullptr));
+    }
+    written.push_back(expected);
+  }
+  EXPECT_TRUE(writer.close());
+  return written;
+}
+
+// Read every board back in a scattered order, then with each thread count
+void check_round_trip(const std::string& path, const GameSettings& settings,
+                      bool labels, const std::vector<Expected>& written,
+                      std::size_t blocks) {
+  CorpusReader reader;
+  ASSERT_TRUE(reader.open(path));
+  EXPECT_EQ(reader.board_count(), written.size());
+  EXPECT_EQ(reader.block_count(), blocks);
+  EXPECT_EQ(reader.has_labels(), labels);
+  EXPECT_EQ(reader.settings().rows, settings.rows);
+  EXPECT_EQ(reader.settings().columns, settings.columns);
+  EXPECT_EQ(reader.settings().bombs, settings.bombs);
+
+  GameBoard board;
+  const std::uint64_t count = written.size();
+  for (std::uint64_t k = 0; k < count; ++k) {
+    std::uint64_t i = (k * 7) % count;  // 7 is coprime with the counts used
+    BoardLabels read_labels{99, 99, 99, 99};
+    ASSERT_TRUE(reader.read_board(i, board, &read_labels)) << "board " << i;
+    EXPECT_EQ(board.get_seed(), written[i].seed) << "board " << i;
+    EXPECT_EQ(bombs_of(board), written[i].bits) << "board " << i;
+    // Without labels in the corpus, read_labels is left alone
+    EXPECT_TRUE(same_labels(read_labels, labels ? written[i].labels
+                                                : BoardLabels{99, 99, 99, 99}))
+        << "board " << i;
+  }
+  EXPECT_FALSE(reader.read_board(count, board, nullptr));
+
+  for (unsigned int threads : {1u, 2u, 3u, 0u}) {
+    std::vector<int> seen(count, 0);
+    std::vector<std::uint8_t> matches(count, 0);
+    bool ok = read_corpus_parallel(
+        path, threads,
+        [&](unsigned int, std::uint64_t index, const GameBoard& read,
+            const BoardLabels* read_labels) {
+          // Each index is visited by one worker only
+          ++seen[index];
+          matches[index] =
+              read.get_seed() == written[index].seed &&
+              bombs_of(read) == written[index].bits &&
+              (labels ? read_labels &&
+                            same_labels(*read_labels, written[index].labels)
+                      : read_labels == nullptr);
+        });
+    EXPECT_TRUE(ok) << threads << " threads";
+    EXPECT_EQ(seen, std::vector<int>(count, 1)) << threads << " threads";
+    EXPECT_EQ(matches, std::vector<std::uint8_t>(count, 1))
+        << threads << " threads";
+  }
+}
+
+// Overwrite the bytes at offset
+void patch(const std::string& path, std::uint64_t offset,
+           const std::vector<std::uint8_t>& bytes) {
+  std::FILE* file = std::fopen(path.c_str(), "r+b");
+  ASSERT_NE(file, nullptr);
+  std::fseek(file, static_cast<long>(offset), SEEK_SET);
+  std::fwrite(bytes.data(), 1, bytes.size(), file);
+  std::fclose(file);
+}
+
+// File offset of the index, from the footer (see board_corpus.h)
+std::uint64_t index_offset(const std::string& path) {
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  std::uint8_t footer[28] = {};
+  std::fseek(file, -28, SEEK_END);
+  std::fread(footer, 1, sizeof(footer), file);
+  std::fclose(file);
+  std::uint64_t offset = 0;
+  for (int i = 0; i < 8; ++i) {
+    offset |= std::uint64_t{footer[i]} << (8 * i);
+  }
+  return offset;
+}
+
+}  // namespace
+
+TEST(BoardCorpusTest, RoundTripWithLabels) {
+  const std::string path = corpus_path("labels");
+  const GameSettings settings = GameSettings::from_dimensions(13, 21, 40);
+  // 50 boards in blocks of 7: seven full blocks and a partial one
+  std::vector<Expected> written = write_corpus(path, settings, true, 7, 50);
+  check_round_trip(path, settings, true, written, 8);
+  std::filesystem::remove(path);
+}
+
+TEST(BoardCorpusTest, RoundTripWithoutLabels) {
+  const std::string path = corpus_path("no_labels");
+  const GameSettings settings = GameSettings::from_dimensions(9, 9, 10);
+  std::vector<Expected> written = write_corpus(path, settings, false, 4, 12);
+  check_round_trip(path, settings, false, written, 3);
+  std::filesystem::remove(path);
+}
+
+TEST(BoardCorpusTest, RejectsTruncatedFile) {
+  const std::string path = corpus_path("truncated");
+  write_corpus(path, GameSettings::from_dimensions(9, 9, 10), true, 4, 12);
+  const std::uintmax_t size = std::filesystem::file_size(path);
+
+  // Losing the end of the footer, half the file, or all but the header
+  for (std::uintmax_t cut : {std::uintmax_t{1}, size / 2, size - 30}) {
+    std::filesystem::resize_file(path, size - cut);
+    CorpusReader reader;
+    EXPECT_FALSE(reader.open(path)) << "cut " << cut;
+    EXPECT_FALSE(read_corpus_parallel(
+        path, 2, [](unsigned int, std::uint64_t, const GameBoard&,
+                    const BoardLabels*) {}));
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(BoardCorpusTest, RejectsCorruptIndex) {
+  const std::string path = corpus_path("corrupt_index");
+  const GameSettings settings = GameSettings::from_dimensions(9, 9, 10);
+  write_corpus(path, settings, true, 4, 12);
+  const std::uint64_t index = index_offset(path);
+
+  // Index entry: offset (u64), compressed size (u32), board count (u32)
+  const struct {
+    std::uint64_t offset;
+    std::vector<std::uint8_t> bytes;
+  } corruptions[] = {
+      // More boards than a block holds
+      {index + 12, {5, 0, 0, 0}},
+      // A short block before the last
+      {index + 16 + 12, {3, 0, 0, 0}},
+      // A block running into the index
+      {index + 8, {0xFF, 0xFF, 0xFF, 0}},
+      // A block inside the header
+      {index + 16, {0, 0, 0, 0, 0, 0, 0, 0}},
+  };
+  for (const auto& corruption : corruptions) {
+    write_corpus(path, settings, true, 4, 12);
+    patch(path, corruption.offset, corruption.bytes);
+    CorpusReader reader;
+    EXPECT_FALSE(reader.open(path)) << "offset " << corruption.offset;
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(BoardCorpusTest, RejectsCorruptBlock) {
+  const std::string path = corpus_path("corrupt_block");
+  write_corpus(path, GameSettings::from_dimensions(9, 9, 10), false, 4, 12);
+  // Damage the zlib stream of the first block, just after the header
+  patch(path, 28 + 4, {0xDE, 0xAD, 0xBE, 0xEF});
+
+  CorpusReader reader;
+  ASSERT_TRUE(reader.open(path));
+  GameBoard board;
+  EXPECT_FALSE(reader.read_board(0, board, nullptr));
+  EXPECT_TRUE(reader.read_board(4, board, nullptr));
+  EXPECT_FALSE(read_corpus_parallel(
+      path, 2, [](unsigned int, std::uint64_t, const GameBoard&,
+                  const BoardLabels*) {}));
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,84 @@
+// A seed gives the same board whatever the number of generation threads
+// (see board_generator.h).
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "board_generator.h"
+#include "game_board.h"
+
+namespace {
+
+// Large enough to be generated in parallel, with a last band shorter than
+// the others
+constexpr unsigned int kRows = 1000;
+constexpr unsigned int kColumns = 1100;
+constexpr unsigned int kBombs = kRows * kColumns / 6;
+static_assert(kRows * kColumns >= kMinParallelGenerationCells,
+              "The board must be large enough for parallel generation");
+
+GameSettings large_settings() {
+  return GameSettings::from_dimensions(kRows, kColumns, kBombs);
+}
+
+// Number of cells whose bomb or count differ
+std::uint64_t count_differences(const GameBoard& a, const GameBoard& b) {
+  std::uint64_t differences = 0;
+  for (unsigned int row = 0; row < a.get_rows(); ++row) {
+    for (unsigned int col = 0; col < a.get_columns(); ++col) {
+      const Cell& x = a.get_cell(row, col);
+      const Cell& y = b.get_cell(row, col);
+      if (x.has_bomb() != y.has_bomb() ||
+          x.get_bomb_count() != y.get_bomb_count()) {
+        ++differences;
+      }
+    }
+  }
+  return differences;
+}
+
+}  // namespace
+
+TEST(BoardGeneratorTest, SameBoardForAnyThreadCount) {
+  GameBoard single;
+  single.set_generation_threads(1);
+  ASSERT_TRUE(single.change_settings(large_settings()));
+  single.reset(42);
+  single.generate();
+
+  for (unsigned int threads : {2u, 3u, 8u, 0u}) {
+    GameBoard parallel;
+    parallel.set_generation_threads(threads);
+    ASSERT_TRUE(parallel.change_settings(large_settings()));
+    parallel.reset(42);
+    parallel.generate();
+    EXPECT_EQ(count_differences(single, parallel), 0u)
+        << "threads: " << threads;
+  }
+}
+
+TEST(BoardGeneratorTest, SameBoardForAnyThreadCountAfterFirstClick) {
+  // The first click keeps a safe zone around (row, column) free of bombs
+  const unsigned int row = kRows / 2 + 13;
+  const unsigned int column = kColumns - 1;
+
+  GameBoard single;
+  single.set_generation_threads(1);
+  ASSERT_TRUE(single.change_settings(large_settings()));
+  single.reset(7);
+  single.open_cell(row, column);
+  ASSERT_TRUE(single.is_generated());
+  EXPECT_FALSE(single.get_cell(row, column).has_bomb());
+
+  for (unsigned int threads : {2u, 5u, 0u}) {
+    GameBoard parallel;
+    parallel.set_generation_threads(threads);
+    ASSERT_TRUE(parallel.change_settings(large_settings()));
+    parallel.reset(7);
+    parallel.open_cell(row, column);
+    EXPECT_EQ(count_differences(single, parallel), 0u)
+        << "threads: " << threads;
+    EXPECT_EQ(parallel.get_opened_count(), single.get_opened_count());
+  }
+}
@@ -0,0 +1,109 @@
+// TiledGameBoard plays exactly like GameBoard: same bombs from a seed, same
+// cells after every click, whatever the board's size is against the tiles.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+
+#include "board_layout.h"
+#include "game_board.h"
+
+namespace {
+
+// Every cell, as a player and the generator see it
+::testing::AssertionResult same_cells(const GameBoard& expected,
+                                      const TiledGameBoard& actual) {
+  for (unsigned int row = 0; row < expected.get_rows(); ++row) {
+    for (unsigned int col = 0; col < expected.get_columns(); ++col) {
+      const Cell& a = expected.get_cell(row, col);
+      const Cell& b = actual.get_cell(row, col);
+      if (a.is_open() != b.is_open() || a.has_flag() != b.has_flag() ||
+          a.has_bomb() != b.has_bomb() ||
+          a.get_bomb_count() != b.get_bomb_count()) {
+        return ::testing::AssertionFailure()
+               << "cell (" << row << ", " << col << ") differs";
+      }
+    }
+  }
+  return ::testing::AssertionSuccess();
+}
+
+}  // namespace
+
+TEST(BoardLayoutTest, TiledBoardMatchesRowMajorBoard) {
+  // Multiples of the 8x8 tile, sizes around them, and single rows/columns
+  const GameSettings settings[] = {
+      GameSettings::from_difficulty(Difficulty::Easy),
+      GameSettings::from_difficulty(Difficulty::Hard),
+      GameSettings::from_dimensions(14, 14, 20),
+      GameSettings::from_dimensions(13, 21, 40),
+      GameSettings::from_dimensions(17, 9, 12),
+      GameSettings::from_dimensions(1, 50, 6),
+      GameSettings::from_dimensions(50, 1, 6),
+      GameSettings::from_dimensions(1, 7, 1),
+      GameSettings::from_dimensions(64, 64, 3),
+  };
+
+  GameBoard expected;
+  TiledGameBoard actual;
+  for (const GameSettings& s : settings) {
+    ASSERT_TRUE(expected.change_settings(s));
+    ASSERT_TRUE(actual.change_settings(s));
+    std::mt19937 rng(7);
+    for (std::uint64_t seed = 1; seed <= 40; ++seed) {
+      SCOPED_TRACE(::testing::Message() << s.rows << "x" << s.columns
+                                        << " with " << s.bombs
+                                        << " bombs, seed " << seed);
+      expected.reset(seed);
+      actual.reset(seed);
+
+      // Random clicks and flags until the game ends, the first click
+      // placing the bombs around it
+      while (expected.get_game_state() == GameState::Playing) {
+        unsigned int row = rng() % s.rows;
+        unsigned int col = rng() % s.columns;
+        if (rng() % 5 == 0) {
+          expected.toggle_flag(row, col);
+          actual.toggle_flag(row, col);
+        } else {
+          ASSERT_EQ(expected.open_cell(row, col), actual.open_cell(row, col));
+          ASSERT_EQ(expected.get_opened_count(), actual.get_opened_count());
+        }
+        ASSERT_EQ(expected.get_game_state(), actual.get_game_state());
+        ASSERT_TRUE(same_cells(expected, actual));
+      }
+    }
+
+    // Boards generated without a click as well
+    expected.reset(99);
+    actual.reset(99);
+    expected.generate();
+    actual.generate();
+    EXPECT_TRUE(same_cells(expected, actual));
+  }
+}
+
+TEST(BoardLayoutTest, RejectsOverflowingTiledPadding) {
+  // Fits a row-major layout in 32 bits, but not once each edge is padded to
+  // whole tiles
+  const GameSettings settings = GameSettings::from_dimensions(1, 1431655761, 1);
+  ASSERT_TRUE(settings.is_valid());
+  EXPECT_TRUE(BoardLayout::fits(settings.rows, settings.columns));
+  EXPECT_FALSE(TiledBoardLayout::fits(settings.rows, settings.columns));
+
+  // The board keeps its old settings and still plays
+  TiledGameBoard board;
+  ASSERT_TRUE(board.change_settings(GameSettings::from_dimensions(9, 9, 10)));
+  EXPECT_FALSE(board.change_settings(settings));
+  EXPECT_EQ(board.get_rows(), 9u);
+  EXPECT_EQ(board.get_columns(), 9u);
+  board.reset(1);
+  EXPECT_TRUE(board.open_cell(4, 4));
+  EXPECT_GT(board.get_opened_count(), 0u);
+
+  // The widest board one tile row high, and one row or column past it
+  EXPECT_TRUE(TiledBoardLayout::fits(6, 536870902));
+  EXPECT_FALSE(TiledBoardLayout::fits(6, 536870903));
+  EXPECT_FALSE(TiledBoardLayout::fits(7, 536870902));
+}
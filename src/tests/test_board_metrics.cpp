@@ -0,0 +1,147 @@
+// BoardAnalyzer against a naive flood fill on seeded boards
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "board_metrics.h"
+#include "game_board.h"
+
+namespace {
+
+// Reference metrics by breadth-first search over (row, column) pairs
+BoardMetrics naive_metrics(const GameBoard& board) {
+  const int rows = static_cast<int>(board.get_rows());
+  const int columns = static_cast<int>(board.get_columns());
+  auto at = [&](int row, int col) -> const Cell& {
+    return board.get_cell(static_cast<unsigned int>(row),
+                          static_cast<unsigned int>(col));
+  };
+  auto is_empty = [&](int row, int col) {
+    return !at(row, col).has_bomb() && at(row, col).get_bomb_count() == 0;
+  };
+  auto for_each_neighbor = [&](int row, int col, auto&& fn) {
+    for (int dr = -1; dr <= 1; ++dr) {
+      for (int dc = -1; dc <= 1; ++dc) {
+        int r = row + dr;
+        int c = col + dc;
+        if ((dr != 0 || dc != 0) && r >= 0 && c >= 0 && r < rows &&
+            c < columns) {
+          fn(r, c);
+        }
+      }
+    }
+  };
+
+  BoardMetrics metrics;
+  std::vector<int> seen(static_cast<std::size_t>(rows) * columns, -1);
+  std::vector<bool> opened(seen.size(), false);
+  std::vector<int> queue;
+
+  // Openings: flood the empty cells, counting the numbers around them once
+  int opening = 0;
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < columns; ++col) {
+      if (!is_empty(row, col) || seen[row * columns + col] >= 0) {
+        continue;
+      }
+      unsigned int size = 0;
+      queue.assign(1, row * columns + col);
+      seen[row * columns + col] = opening;
+      while (!queue.empty()) {
+        int n = queue.back();
+        queue.pop_back();
+        ++size;
+        opened[n] = true;
+        for_each_neighbor(n / columns, n % columns, [&](int r, int c) {
+          int m = r * columns + c;
+          if (seen[m] == opening) {
+            return;
+          }
+          seen[m] = opening;
+          if (is_empty(r, c)) {
+            queue.push_back(m);
+          } else {
+            ++size;  // A number on the border
+            opened[m] = true;
+          }
+        });
+      }
+      metrics.opening_sizes.push_back(size);
+      metrics.largest_opening = std::max(metrics.largest_opening, size);
+      ++opening;
+    }
+  }
+  metrics.openings = static_cast<unsigned int>(opening);
+
+  // Islands: numbers no opening reveals, flooded among themselves
+  std::vector<bool> visited(seen.size(), false);
+  for (int n = 0; n < rows * columns; ++n) {
+    if (at(n / columns, n % columns).has_bomb() || opened[n]) {
+      continue;
+    }
+    ++metrics.isolated_numbers;
+    if (visited[n]) {
+      continue;
+    }
+    ++metrics.islands;
+    queue.assign(1, n);
+    visited[n] = true;
+    while (!queue.empty()) {
+      int m = queue.back();
+      queue.pop_back();
+      for_each_neighbor(m / columns, m % columns, [&](int r, int c) {
+        int k = r * columns + c;
+        if (!visited[k] && !at(r, c).has_bomb() && !opened[k]) {
+          visited[k] = true;
+          queue.push_back(k);
+        }
+      });
+    }
+  }
+  metrics.bbbv = metrics.openings + metrics.isolated_numbers;
+  return metrics;
+}
+
+}  // namespace
+
+TEST(BoardMetricsTest, MatchesNaiveFloodFill) {
+  const GameSettings settings[] = {
+      GameSettings::from_difficulty(Difficulty::Easy),
+      GameSettings::from_difficulty(Difficulty::Normal),
+      GameSettings::from_difficulty(Difficulty::Hard),
+      GameSettings::from_dimensions(1, 40, 6),
+      GameSettings::from_dimensions(37, 1, 5),
+      GameSettings::from_dimensions(23, 57, 60),
+      GameSettings::from_dimensions(23, 57, 400),
+      GameSettings::from_dimensions(64, 64, 1),
+  };
+
+  GameBoard board;
+  BoardAnalyzer analyzer;
+  for (const GameSettings& s : settings) {
+    ASSERT_TRUE(board.change_settings(s));
+    for (std::uint64_t seed = 1; seed <= 200; ++seed) {
+      board.reset(seed);
+      board.generate();
+      BoardMetrics expected = naive_metrics(board);
+      const BoardMetrics& actual = analyzer.analyze(board);
+
+      SCOPED_TRACE(::testing::Message()
+                   << s.rows << "x" << s.columns << " with " << s.bombs
+                   << " bombs, seed " << seed);
+      EXPECT_EQ(actual.bbbv, expected.bbbv);
+      EXPECT_EQ(actual.openings, expected.openings);
+      EXPECT_EQ(actual.islands, expected.islands);
+      EXPECT_EQ(actual.isolated_numbers, expected.isolated_numbers);
+      EXPECT_EQ(actual.largest_opening, expected.largest_opening);
+
+      std::vector<unsigned int> actual_sizes = actual.opening_sizes;
+      std::sort(actual_sizes.begin(), actual_sizes.end());
+      std::sort(expected.opening_sizes.begin(), expected.opening_sizes.end());
+      EXPECT_EQ(actual_sizes, expected.opening_sizes);
+    }
+  }
+}
@@ -0,0 +1,81 @@
+// GameSimulation: input reaches the logic thread without the render thread
+// taking a lock, and snapshots show what the player sees.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "game_simulation.h"
+
+namespace {
+
+// Wait until the logic thread publishes a revision other than `revision`.
+// Returns false after a second, e.g. if a wakeup was lost.
+bool wait_for_publish(GameSimulation& simulation, std::uint64_t revision) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (simulation.latest_board().get_revision() == revision) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(GameSimulationTest, WakesParkedLogicThread) {
+  GameSimulation simulation;
+  simulation.start();
+  for (unsigned int i = 0; i < 300; ++i) {
+    // Give the logic thread time to park on some iterations only, so pushes
+    // race with it going to sleep
+    if (i % 3 == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    std::uint64_t revision = simulation.latest_board().get_revision();
+    ASSERT_TRUE(simulation.push_input(InputEvent::toggle_flag(0, 0)));
+    ASSERT_TRUE(wait_for_publish(simulation, revision)) << "iteration " << i;
+  }
+  simulation.stop();
+}
+
+TEST(GameSimulationTest, SnapshotShowsTheBoard) {
+  GameSimulation simulation;
+  simulation.start();
+  std::uint64_t revision = simulation.latest_board().get_revision();
+  simulation.push_input(InputEvent::reset());
+  simulation.push_input(InputEvent::open_cell(4, 5));
+  simulation.push_input(InputEvent::toggle_flag(0, 0));
+
+  // The three events may be published in more than one batch
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (!simulation.latest_board().get_cell(0, 0).has_flag() &&
+         !simulation.latest_board().get_cell(0, 0).is_open()) {
+    ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+    std::this_thread::yield();
+  }
+  const GameBoard& board = simulation.latest_board();
+  EXPECT_NE(board.get_revision(), revision);
+  EXPECT_TRUE(board.is_generated());
+  EXPECT_TRUE(board.get_cell(4, 5).is_open());
+  EXPECT_FALSE(board.get_cell(4, 5).has_bomb());
+  EXPECT_EQ(board.get_game_state(), GameState::Playing);
+  // Only the visible state is published
+  EXPECT_EQ(board.get_opened_count(), 0u);
+  simulation.stop();
+}
+
+TEST(GameSimulationTest, FullQueueRejectsInput) {
+  // Not started, so nothing drains the queue
+  GameSimulation simulation;
+  unsigned int accepted = 0;
+  while (simulation.push_input(InputEvent::toggle_flag(0, 0))) {
+    ASSERT_LT(++accepted, 100000u);
+  }
+  EXPECT_GT(accepted, 0u);
+  EXPECT_FALSE(simulation.push_input(InputEvent::reset()));
+}
@@ -0,0 +1,211 @@
+// The vectorized environment through its C ABI. Each environment board is
+// mirrored by a GameBoard from the same seed, which sees the same bombs.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "game_board.h"
+#include "minesweeper_env.h"
+
+namespace {
+
+// Observation of a whole board, encoded as minesweeper_env.h describes
+std::vector<std::uint8_t> encode(const GameBoard& board) {
+  std::vector<std::uint8_t> observation;
+  for (unsigned int row = 0; row < board.get_rows(); ++row) {
+    for (unsigned int col = 0; col < board.get_columns(); ++col) {
+      const Cell& cell = board.get_cell(row, col);
+      if (!cell.is_open()) {
+        observation.push_back(cell.has_flag() ? 10 : 9);
+      } else if (cell.has_bomb()) {
+        observation.push_back(11);
+      } else {
+        observation.push_back(static_cast<std::uint8_t>(cell.get_bomb_count()));
+      }
+    }
+  }
+  return observation;
+}
+
+// First closed cell of `board` with (or without) a bomb, as an action
+std::int32_t find_cell(const GameBoard& board, bool bomb) {
+  for (unsigned int row = 0; row < board.get_rows(); ++row) {
+    for (unsigned int col = 0; col < board.get_columns(); ++col) {
+      const Cell& cell = board.get_cell(row, col);
+      if (!cell.is_open() && cell.has_bomb() == bomb) {
+        return static_cast<std::int32_t>(row * board.get_columns() + col);
+      }
+    }
+  }
+  return -1;
+}
+
+// Environment with a single board and its mirror
+class EnvTest : public ::testing::Test {
+ protected:
+  void start(unsigned int rows, unsigned int columns, unsigned int bombs,
+             std::uint64_t seed) {
+    env_ = ms_vec_env_create(1, rows, columns, bombs, seed);
+    ASSERT_NE(env_, nullptr);
+    observation_.assign(ms_vec_env_observation_size(env_), 0);
+    ms_vec_env_reset(env_, observation_.data());
+    mirror_.change_settings(
+        GameSettings::from_dimensions(rows, columns, bombs));
+    mirror_.reset(seed);
+    safe_cells_ = static_cast<float>(rows * columns - bombs);
+  }
+
+  void TearDown() override { ms_vec_env_destroy(env_); }
+
+  // Step the environment and the mirror with the same action
+  void step(std::int32_t action) {
+    ASSERT_EQ(ms_vec_env_step(env_, &action, observation_.data(), &reward_,
+                              &done_),
+              0);
+    const unsigned int cells = mirror_.get_rows() * mirror_.get_columns();
+    const unsigned int columns = mirror_.get_columns();
+    unsigned int cell = static_cast<unsigned int>(action) % cells;
+    if (static_cast<unsigned int>(action) < cells) {
+      mirror_.open_cell(cell / columns, cell % columns);
+    } else {
+      mirror_.toggle_flag(cell / columns, cell % columns);
+    }
+  }
+
+  MsVecEnv* env_ = nullptr;
+  std::vector<std::uint8_t> observation_;
+  GameBoard mirror_;
+  float safe_cells_ = 0.0f;
+  float reward_ = 0.0f;
+  std::uint8_t done_ = 0;
+};
+
+}  // namespace
+
+TEST_F(EnvTest, ResetShowsClosedBoard) {
+  start(9, 9, 10, 3);
+  EXPECT_EQ(ms_vec_env_num_envs(env_), 1u);
+  EXPECT_EQ(ms_vec_env_num_actions(env_), 162u);
+  EXPECT_EQ(observation_, std::vector<std::uint8_t>(81, 9));
+}
+
+TEST_F(EnvTest, FloodMatchesFullEncode) {
+  // Few bombs, so the first click opens most of the board
+  start(64, 96, 30, 11);
+  step(32 * 96 + 48);
+  ASSERT_GT(mirror_.get_opened_count(), 100u);
+  EXPECT_EQ(observation_, encode(mirror_));
+  EXPECT_FLOAT_EQ(reward_, mirror_.get_opened_count() / safe_cells_);
+
+  // Later clicks rewrite only their own cells
+  for (int i = 0; i < 5 && mirror_.get_game_state() == GameState::Playing;
+       ++i) {
+    step(find_cell(mirror_, false));
+    if (!done_) {
+      EXPECT_EQ(observation_, encode(mirror_));
+    }
+  }
+}
+
+TEST_F(EnvTest, ClearingSumsToOneAndResets) {
+  start(16, 16, 40, 5);
+  step(8 * 16 + 8);
+  float total = reward_;
+  EXPECT_EQ(observation_, encode(mirror_));
+
+  // A flag changes only its cell and gives nothing
+  std::int32_t flag = find_cell(mirror_, true);
+  step(256 + flag);
+  EXPECT_EQ(reward_, 0.0f);
+  EXPECT_EQ(observation_[flag], 10);
+  step(256 + flag);
+  EXPECT_EQ(observation_[flag], 9);
+
+  while (!done_) {
+    step(find_cell(mirror_, false));
+    total += reward_;
+    if (!done_) {
+      EXPECT_EQ(observation_, encode(mirror_));
+    }
+  }
+  EXPECT_EQ(mirror_.get_game_state(), GameState::Cleared);
+  EXPECT_NEAR(total, 1.0f, 1e-4f);
+  // The next episode has already started
+  EXPECT_EQ(observation_, std::vector<std::uint8_t>(256, 9));
+}
+
+TEST_F(EnvTest, BombEndsEpisode) {
+  start(16, 16, 40, 8);
+  step(0);
+  ASSERT_EQ(done_, 0);
+  step(find_cell(mirror_, true));
+  EXPECT_EQ(mirror_.get_game_state(), GameState::GameOver);
+  EXPECT_EQ(reward_, -1.0f);
+  EXPECT_EQ(done_, 1);
+  EXPECT_EQ(observation_, std::vector<std::uint8_t>(256, 9));
+
+  // The next episode uses the next seed
+  mirror_.reset(9);
+  step(5);
+  EXPECT_EQ(observation_, encode(mirror_));
+}
+
+TEST(EnvAbiTest, StepsEveryBoard) {
+  const unsigned int count = 4;
+  MsVecEnv* env = ms_vec_env_create(count, 12, 20, 25, 100);
+  ASSERT_NE(env, nullptr);
+  const unsigned int cells = ms_vec_env_observation_size(env);
+  std::vector<std::uint8_t> observations(count * cells);
+  ms_vec_env_reset(env, observations.data());
+
+  std::vector<std::int32_t> actions = {0, 37, 120, 239};
+  std::vector<float> rewards(count);
+  std::vector<std::uint8_t> dones(count);
+  ASSERT_EQ(ms_vec_env_step(env, actions.data(), observations.data(),
+                            rewards.data(), dones.data()),
+            0);
+  for (unsigned int i = 0; i < count; ++i) {
+    GameBoard mirror;
+    mirror.change_settings(GameSettings::from_dimensions(12, 20, 25));
+    mirror.reset(100 + i);
+    mirror.open_cell(actions[i] / 20, actions[i] % 20);
+    std::vector<std::uint8_t> board(observations.begin() + i * cells,
+                                    observations.begin() + (i + 1) * cells);
+    EXPECT_EQ(board, encode(mirror)) << "board " << i;
+    EXPECT_EQ(dones[i], 0);
+  }
+  ms_vec_env_destroy(env);
+}
+
+TEST(EnvAbiTest, RejectsBadSizes) {
+  EXPECT_EQ(ms_vec_env_create(0, 9, 9, 10, 1), nullptr);
+  EXPECT_EQ(ms_vec_env_create(1, 0, 9, 10, 1), nullptr);
+  EXPECT_EQ(ms_vec_env_create(1, 9, 0, 10, 1), nullptr);
+  EXPECT_EQ(ms_vec_env_create(1, 9, 9, 81, 1), nullptr);
+  // Padded indices or actions that don't fit in 32 bits
+  EXPECT_EQ(ms_vec_env_create(1, 65537, 65537, 1, 1), nullptr);
+  EXPECT_EQ(ms_vec_env_create(1, 1, 1431655764, 1, 1), nullptr);
+  EXPECT_EQ(ms_vec_env_create(1, 32768, 32768, 1, 1), nullptr);
+}
+
+TEST(EnvAbiTest, RejectsBadActions) {
+  MsVecEnv* env = ms_vec_env_create(2, 9, 9, 10, 1);
+  ASSERT_NE(env, nullptr);
+  std::vector<std::uint8_t> observations(2 * 81);
+  ms_vec_env_reset(env, observations.data());
+  const std::vector<std::uint8_t> before = observations;
+
+  float rewards[2];
+  std::uint8_t dones[2];
+  for (std::int32_t bad : {-1, 162, 1000}) {
+    // The first board's valid action must not be applied either
+    std::int32_t actions[2] = {40, bad};
+    EXPECT_EQ(ms_vec_env_step(env, actions, observations.data(), rewards,
+                              dones),
+              -1);
+    EXPECT_EQ(observations, before);
+  }
+  ms_vec_env_destroy(env);
+}
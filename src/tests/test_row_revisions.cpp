@@ -0,0 +1,91 @@
+// GameBoard::get_row_revision() marks every row a change touched, so an
+// observer can refresh only those rows (see Renderer::update_atlas()).
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "game_board.h"
+
+namespace {
+
+// What a player sees of one row
+template <typename Board>
+std::vector<std::uint8_t> row_codes(const Board& board, unsigned int row) {
+  std::vector<std::uint8_t> codes;
+  for (unsigned int col = 0; col < board.get_columns(); ++col) {
+    const Cell& cell = board.get_cell(row, col);
+    codes.push_back(!cell.is_open()    ? (cell.has_flag() ? 10 : 9)
+                    : cell.has_bomb() ? 11
+                                      : cell.get_bomb_count());
+  }
+  return codes;
+}
+
+// Random clicks and flags; after each, every row that looks different must
+// have a newer revision
+template <typename Board>
+void check_random_play(unsigned int rows, unsigned int columns,
+                       unsigned int bombs) {
+  Board board;
+  ASSERT_TRUE(board.change_settings(
+      GameSettings::from_dimensions(rows, columns, bombs)));
+  std::mt19937 rng(5);
+  for (std::uint64_t seed = 1; seed <= 20; ++seed) {
+    std::uint64_t revision = board.get_revision();
+    board.reset(seed);
+    for (unsigned int row = 0; row < rows; ++row) {
+      EXPECT_GT(board.get_row_revision(row), revision);
+    }
+
+    while (board.get_game_state() == GameState::Playing) {
+      std::vector<std::vector<std::uint8_t>> before;
+      for (unsigned int row = 0; row < rows; ++row) {
+        before.push_back(row_codes(board, row));
+      }
+      revision = board.get_revision();
+      unsigned int row = rng() % rows;
+      unsigned int col = rng() % columns;
+      if (rng() % 4 == 0) {
+        board.toggle_flag(row, col);
+      } else {
+        board.open_cell(row, col);
+      }
+      for (unsigned int r = 0; r < rows; ++r) {
+        if (row_codes(board, r) != before[r]) {
+          EXPECT_GT(board.get_row_revision(r), revision)
+              << "seed " << seed << ", row " << r;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(RowRevisionTest, MarksChangedRows) {
+  check_random_play<GameBoard>(30, 40, 60);
+  check_random_play<GameBoard>(1, 50, 5);
+}
+
+TEST(RowRevisionTest, MarksChangedRowsOfTiledBoard) {
+  check_random_play<TiledGameBoard>(30, 40, 60);
+  check_random_play<TiledGameBoard>(17, 9, 12);
+}
+
+TEST(RowRevisionTest, VisibleCopyKeepsRowRevisions) {
+  GameBoard board;
+  board.reset(3);
+  board.open_cell(5, 5);
+  board.toggle_flag(0, 0);
+
+  GameBoard copy;
+  copy.copy_visible_state(board);
+  EXPECT_EQ(copy.get_revision(), board.get_revision());
+  for (unsigned int row = 0; row < board.get_rows(); ++row) {
+    EXPECT_EQ(copy.get_row_revision(row), board.get_row_revision(row));
+    EXPECT_EQ(row_codes(copy, row), row_codes(board, row));
+  }
+}
@@ -0,0 +1,274 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+namespace trace_internal {
+
+std::atomic<bool> g_enabled{false};
+
+}  // namespace trace_internal
+
+namespace {
+
+// Events kept per thread; older ones are overwritten
+constexpr std::size_t kRingCapacity = std::size_t{1} << 16;
+
+// Name shared by all flow events; Perfetto matches flows on it and the id
+const char* kFlowName = "input";
+
+struct Event {
+  const char* name;
+  std::int64_t start_ns;
+  std::int64_t end_ns;
+  std::uint64_t flow_id;
+  char phase;  // Trace-event phase: 'X' slice, 's' / 't' / 'f' flow
+};
+
+struct ThreadRing {
+  // Only contended while a flush copies the events
+  std::mutex mutex;
+  // kRingCapacity events while the thread runs, only the recorded ones after
+  std::vector<Event> events;
+  std::uint64_t written = 0;
+  unsigned int thread_id = 0;
+  std::string name;
+};
+
+struct Registry {
+  std::mutex mutex;
+  // Never freed, so a thread's events outlive the thread
+  std::vector<std::unique_ptr<ThreadRing>> rings;
+  // Buffers of exited threads, for the next threads that record
+  std::vector<std::vector<Event>> spare_buffers;
+  std::string path;
+  std::int64_t start_ns = 0;
+};
+
+Registry& registry() {
+  static Registry instance;
+  return instance;
+}
+
+std::atomic<std::uint64_t> g_next_flow_id{1};
+thread_local ThreadRing* t_ring = nullptr;
+thread_local const char* t_thread_name = nullptr;
+
+// Shrink an exited thread's ring to its recorded events and hand its buffer
+// to the next thread, so short-lived workers (e.g. board generation bands)
+// don't each keep a full ring
+void retire_ring(ThreadRing& ring) {
+  std::vector<Event> buffer;
+  {
+    std::lock_guard<std::mutex> lock(ring.mutex);
+    std::uint64_t count = std::min<std::uint64_t>(ring.written, kRingCapacity);
+    std::vector<Event> recorded;
+    recorded.reserve(count);
+    for (std::uint64_t i = ring.written - count; i < ring.written; ++i) {
+      recorded.push_back(ring.events[i % kRingCapacity]);
+    }
+    buffer.swap(ring.events);
+    ring.events = std::move(recorded);
+    ring.written = count;  // Oldest first, as trace_flush() reads them
+  }
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.spare_buffers.push_back(std::move(buffer));
+}
+
+// Retires the thread's ring when the thread exits
+struct RingReleaser {
+  ~RingReleaser() {
+    if (t_ring) {
+      retire_ring(*t_ring);
+      t_ring = nullptr;
+    }
+  }
+};
+thread_local RingReleaser t_ring_releaser;
+
+// The calling thread's ring, created with its first event so threads that
+// never record cost nothing
+ThreadRing& thread_ring() {
+  if (!t_ring) {
+    auto ring = std::make_unique<ThreadRing>();
+    if (t_thread_name) {
+      ring->name = t_thread_name;
+    }
+    Registry& reg = registry();
+    {
+      std::lock_guard<std::mutex> lock(reg.mutex);
+      if (!reg.spare_buffers.empty()) {
+        ring->events = std::move(reg.spare_buffers.back());
+        reg.spare_buffers.pop_back();
+      }
+      ring->thread_id = static_cast<unsigned int>(reg.rings.size()) + 1;
+      t_ring = ring.get();
+      reg.rings.push_back(std::move(ring));
+    }
+    // Outside the lock, and only for the first threads
+    if (t_ring->events.size() != kRingCapacity) {
+      t_ring->events.resize(kRingCapacity);
+    }
+    static_cast<void>(&t_ring_releaser);  // Registers its destructor
+  }
+  return *t_ring;
+}
+
+void record(const Event& event) {
+  ThreadRing& ring = thread_ring();
+  std::lock_guard<std::mutex> lock(ring.mutex);
+  ring.events[ring.written % kRingCapacity] = event;
+  ++ring.written;
+}
+
+void record_flow(char phase, std::uint64_t id) {
+  std::int64_t now = trace_internal::now_ns();
+  record(Event{kFlowName, now, now, id, phase});
+}
+
+// Names are our own literals, but keep the JSON valid regardless
+void write_escaped(std::FILE* file, const char* text) {
+  for (; *text; ++text) {
+    if (*text == '"' || *text == '\\') {
+      std::fputc('\\', file);
+    }
+    std::fputc(*text, file);
+  }
+}
+
+}  // namespace
+
+namespace trace_internal {
+
+void record_slice(const char* name, std::int64_t start_ns,
+                  std::int64_t end_ns) {
+  record(Event{name, start_ns, end_ns, 0, 'X'});
+}
+
+std::uint64_t flow_begin() {
+  if (!enabled()) {
+    return 0;
+  }
+  std::uint64_t id = g_next_flow_id.fetch_add(1, std::memory_order_relaxed);
+  record_flow('s', id);
+  return id;
+}
+
+void flow_step(std::uint64_t id) {
+  if (id != 0 && enabled()) {
+    record_flow('t', id);
+  }
+}
+
+void flow_end(std::uint64_t id) {
+  if (id != 0 && enabled()) {
+    record_flow('f', id);
+  }
+}
+
+}  // namespace trace_internal
+
+bool trace_start(const std::string& path) {
+  Registry& reg = registry();
+  {
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (trace_internal::enabled()) {
+      return false;
+    }
+    reg.path = path;
+    reg.start_ns = trace_internal::now_ns();
+  }
+  trace_internal::g_enabled.store(true, std::memory_order_release);
+  return true;
+}
+
+const std::string& trace_path() { return registry().path; }
+
+void trace_set_thread_name(const char* name) {
+  t_thread_name = name;
+  if (t_ring) {
+    std::lock_guard<std::mutex> lock(t_ring->mutex);
+    t_ring->name = name;
+  }
+}
+
+bool trace_flush() {
+  if (!trace_internal::enabled()) {
+    return false;
+  }
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> registry_lock(reg.mutex);
+
+  std::string temporary = reg.path + ".tmp";
+  std::FILE* file = std::fopen(temporary.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+
+  std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  std::fprintf(file,
+               "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,"
+               "\"tid\":0,\"args\":{\"name\":\"Minesweeper\"}}");
+
+  // Copy each ring first, so recording threads only wait for the copy
+  std::vector<Event> events;
+  std::string name;
+  for (const std::unique_ptr<ThreadRing>& ring : reg.rings) {
+    {
+      std::lock_guard<std::mutex> lock(ring->mutex);
+      std::uint64_t count = std::min<std::uint64_t>(ring->written,
+                                                    kRingCapacity);
+      events.clear();
+      for (std::uint64_t i = ring->written - count; i < ring->written; ++i) {
+        events.push_back(ring->events[i % kRingCapacity]);
+      }
+      name = ring->name;
+    }
+
+    unsigned int tid = ring->thread_id;
+    if (!name.empty()) {
+      std::fprintf(file,
+                   ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,"
+                   "\"tid\":%u,\"args\":{\"name\":\"",
+                   tid);
+      write_escaped(file, name.c_str());
+      std::fprintf(file, "\"}}");
+    }
+    for (const Event& event : events) {
+      double ts = (event.start_ns - reg.start_ns) / 1e3;
+      std::fprintf(file, ",\n{\"ph\":\"%c\",\"name\":\"", event.phase);
+      write_escaped(file, event.name);
+      if (event.phase == 'X') {
+        std::fprintf(file,
+                     "\",\"cat\":\"minesweeper\",\"pid\":1,\"tid\":%u,"
+                     "\"ts\":%.3f,\"dur\":%.3f}",
+                     tid, ts, (event.end_ns - event.start_ns) / 1e3);
+      } else {
+        // Flow events attach to the slice enclosing them
+        std::fprintf(file,
+                     "\",\"cat\":\"flow\",\"id\":%llu,\"pid\":1,\"tid\":%u,"
+                     "\"ts\":%.3f%s}",
+                     static_cast<unsigned long long>(event.flow_id), tid, ts,
+                     event.phase == 'f' ? ",\"bp\":\"e\"" : "");
+      }
+    }
+  }
+  std::fprintf(file, "\n]}\n");
+
+  // Replace the previous flush only once this one is complete
+  std::error_code error;
+  if (std::fclose(file) == 0) {
+    std::filesystem::rename(temporary, reg.path, error);
+    if (!error) {
+      return true;
+    }
+  }
+  std::filesystem::remove(temporary, error);
+  return false;
+}
@@ -0,0 +1,100 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Timeline tracing in the Chrome trace-event format, viewable in Perfetto
+// (ui.perfetto.dev) or chrome://tracing.
+//
+// Trace points are compiled in when MINESWEEPER_TRACING is defined (CMake
+// option of the same name) and record nothing until trace_start() is called;
+// the game calls it when the MINESWEEPER_TRACE environment variable names an
+// output file. Each thread records into its own fixed-size ring buffer, so
+// recording never blocks on another thread and old events are overwritten.
+// When a thread exits, its ring keeps only the events it recorded and the
+// buffer is reused by the next thread. trace_flush() writes whatever the
+// rings hold.
+//
+//   TRACE_SCOPE("Renderer::render");  // Slice until the end of the scope
+//
+// Flows link slices on different threads, e.g. a click to the frame that
+// shows its result: TRACE_FLOW_BEGIN() inside one slice returns an id that
+// TRACE_FLOW_STEP(id) and TRACE_FLOW_END(id) continue inside later slices.
+
+// Begin recording; trace_flush() writes to `path`. Returns false if already
+// started.
+bool trace_start(const std::string& path);
+
+// Write every thread's recorded events as JSON, replacing the file. Returns
+// false if tracing isn't started or the file can't be written. Recording
+// continues.
+bool trace_flush();
+
+// Path given to trace_start(), empty if not started
+const std::string& trace_path();
+
+// Label the calling thread in the trace, e.g. "Logic"
+void trace_set_thread_name(const char* name);
+
+namespace trace_internal {
+
+extern std::atomic<bool> g_enabled;
+
+inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+inline std::int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// `name` must outlive the trace, e.g. a string literal
+void record_slice(const char* name, std::int64_t start_ns,
+                  std::int64_t end_ns);
+std::uint64_t flow_begin();
+void flow_step(std::uint64_t id);
+void flow_end(std::uint64_t id);
+
+}  // namespace trace_internal
+
+// Records a slice from construction to destruction
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name)
+      : name_(name),
+        start_ns_(trace_internal::enabled() ? trace_internal::now_ns() : 0) {}
+
+  ~TraceScope() {
+    if (start_ns_ != 0) {
+      trace_internal::record_slice(name_, start_ns_, trace_internal::now_ns());
+    }
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const char* name_;
+  std::int64_t start_ns_;  // 0 if tracing was off at construction
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef MINESWEEPER_TRACING
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+// 0 if tracing is off; the other flow macros ignore 0
+#define TRACE_FLOW_BEGIN() trace_internal::flow_begin()
+#define TRACE_FLOW_STEP(id) trace_internal::flow_step(id)
+#define TRACE_FLOW_END(id) trace_internal::flow_end(id)
+#else
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#define TRACE_FLOW_BEGIN() std::uint64_t{0}
+#define TRACE_FLOW_STEP(id) static_cast<void>(id)
+#define TRACE_FLOW_END(id) static_cast<void>(id)
+#endif
+
+#endif  // TRACE_H_
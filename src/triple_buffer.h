@@ -0,0 +1,44 @@
+#ifndef TRIPLE_BUFFER_H_
+#define TRIPLE_BUFFER_H_
+
+#include <atomic>
+
+// Lock-free handoff of the latest state from one producer thread to one
+// consumer thread.
+//
+// The producer fills back() and calls publish(); the consumer calls front()
+// to get the newest published state. Neither side ever waits: there is
+// always a third buffer to swap with. A reference returned by front() stays
+// valid until the next call to front().
+template <typename T>
+class TripleBuffer {
+ public:
+  // Producer only: buffer to fill with the next state
+  T& back() { return buffers_[back_]; }
+
+  // Producer only: make back() the newest state
+  void publish() {
+    back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) &
+            kIndexMask;
+  }
+
+  // Consumer only: newest published state
+  const T& front() {
+    if (middle_.load(std::memory_order_relaxed) & kFresh) {
+      front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    }
+    return buffers_[front_];
+  }
+
+ private:
+  static constexpr unsigned int kIndexMask = 0x3;
+  // Set in middle_ when it holds a state the consumer hasn't taken yet
+  static constexpr unsigned int kFresh = 0x4;
+
+  T buffers_[3];
+  unsigned int back_ = 0;  // Producer's buffer
+  std::atomic<unsigned int> middle_{1};
+  unsigned int front_ = 2;  // Consumer's buffer
+};
+
+#endif  // TRIPLE_BUFFER_H_
@@ -4,9 +4,32 @@
 #include <imgui/backends/imgui_impl_opengl3.h>
 #include <imgui/imgui.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
 
 #include "game_settings.h"
+#include "trace.h"
+
+namespace {
+
+// ImGui allocates with malloc, not operator new; count it as UI
+void* imgui_alloc(std::size_t size, void*) {
+  record_allocation(AllocTag::UI, size);
+  return std::malloc(size);
+}
+
+void imgui_free(void* pointer, void*) {
+  if (pointer) {
+    record_free(AllocTag::UI);
+  }
+  std::free(pointer);
+}
+
+}  // namespace
 
 UIManager::UIManager(GLFWwindow* window)
     : window_(window), initialized_(false), large_font_(nullptr) {}
@@ -20,6 +43,7 @@ bool UIManager::initialize() {
 
   // Setup Dear ImGui context
   IMGUI_CHECKVERSION();
+  ImGui::SetAllocatorFunctions(imgui_alloc, imgui_free);
   ImGui::CreateContext();
   ImGuiIO& io = ImGui::GetIO();
   io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
@@ -38,8 +62,17 @@ bool UIManager::initialize() {
       "/usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf";
 #endif
 
-  large_font_ = io.Fonts->AddFontFromFileTTF(
-      font_path, 48.0f);  // Load at 48pt for high quality
+  // The overlay only draws digits and "B". Rasterizing just those at 48pt
+  // keeps the atlas tiny, so building it at startup is near free.
+  static const ImWchar kOverlayGlyphs[] = {'0', '9', 'B', 'B', 0};
+  if (std::ifstream(font_path).good()) {
+    large_font_ = io.Fonts->AddFontFromFileTTF(
+        font_path, 48.0f, nullptr,
+        kOverlayGlyphs);  // Load at 48pt for high quality
+  } else {
+    // Fall back to the default font rather than failing ImGui's assert
+    std::cerr << "Overlay font not found: " << font_path << std::endl;
+  }
   io.Fonts->Build();
 
   // Setup Dear ImGui style
@@ -53,7 +86,10 @@ bool UIManager::initialize() {
   return true;
 }
 
-void UIManager::render(const GameBoard& board) {
+void UIManager::render(const GameBoard& board, const StatsStore& stats,
+                       bool draw_cell_labels, const Hint* hint,
+                       const AllocSnapshot* frame_allocations) {
+  TRACE_SCOPE("UIManager::render");
   // Start the Dear ImGui frame
   ImGui_ImplOpenGL3_NewFrame();
   ImGui_ImplGlfw_NewFrame();
@@ -83,10 +119,24 @@ void UIManager::render(const GameBoard& board) {
     diff_name = "Normal";
   } else if (difficulty == Difficulty::Hard) {
     diff_name = "Hard";
+  } else if (difficulty == Difficulty::Custom) {
+    diff_name = "Custom";
   }
 
   ImGui::Text("Difficulty: %s | 1: Easy | 2: Normal | 3: Hard", diff_name);
 
+  // Current game time and this difficulty's records
+  double elapsed =
+      std::chrono::duration<double>(board.get_timer().elapsed()).count();
+  ImGui::SameLine();
+  ImGui::Text("| Time: %.1f s", elapsed);
+  if (stats.games_won(difficulty) > 0) {
+    ImGui::SameLine();
+    ImGui::Text("| Best: %.1f s | Median: %.1f s",
+                stats.best_time_us(difficulty) / 1e6,
+                stats.percentile_us(difficulty, 0.5) / 1e6);
+  }
+
   if (state == GameState::Playing) {
     ImGui::Text("Press 'R' to restart | Left Click: Open | Right Click: Flag");
   } else if (state == GameState::GameOver) {
@@ -103,16 +153,76 @@ void UIManager::render(const GameBoard& board) {
 
   ImGui::End();
 
-  // Overlay numbers and symbols on game board cells
-  render_game_overlay(board, display_w, display_h);
+  // Overlay numbers and symbols on game board cells, unless the renderer
+  // already drew them, and the hint
+  if (draw_cell_labels || hint) {
+    render_game_overlay(board, display_w, display_h, draw_cell_labels, hint);
+  }
+
+  if (frame_allocations) {
+    render_allocation_panel(*frame_allocations, display_h);
+  }
 
   // Rendering
   ImGui::Render();
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+void UIManager::render_spectator(const ArenaSnapshot& arena,
+                                 const BoardRect* board_rects) {
+  TRACE_SCOPE("UIManager::render_spectator");
+  ImGui_ImplOpenGL3_NewFrame();
+  ImGui_ImplGlfw_NewFrame();
+  ImGui::NewFrame();
+
+  int display_w, display_h;
+  glfwGetFramebufferSize(window_, &display_w, &display_h);
+
+  ImGui::SetNextWindowPos(ImVec2(0, 0));
+  ImGui::SetNextWindowSize(
+      ImVec2((float)display_w, UIConfig::kConsoleBarHeight));
+  ImGui::Begin("Console", nullptr,
+               ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
+                   ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse);
+
+  std::size_t playing = 0;
+  for (const GameBoard& board : arena.boards) {
+    if (board.get_game_state() == GameState::Playing) {
+      ++playing;
+    }
+  }
+  unsigned int finished = arena.games_won + arena.games_lost;
+  ImGui::Text("Spectating %zu bots | %zu playing", arena.boards.size(),
+              playing);
+  ImGui::Text("Won: %u | Lost: %u | Win rate: %.1f%%", arena.games_won,
+              arena.games_lost,
+              finished > 0 ? 100.0 * arena.games_won / finished : 0.0);
+
+  ImGui::End();
+
+  // Numbers the renderer's quad fallback can't draw, over every board
+  if (board_rects) {
+    ImGui::SetNextWindowPos(ImVec2(0, UIConfig::kConsoleBarHeight));
+    ImGui::SetNextWindowSize(
+        ImVec2((float)display_w, display_h - UIConfig::kConsoleBarHeight));
+    ImGui::Begin("GameOverlay", nullptr,
+                 ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
+                     ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse |
+                     ImGuiWindowFlags_NoBackground |
+                     ImGuiWindowFlags_NoInputs);
+    for (std::size_t i = 0; i < arena.boards.size(); ++i) {
+      render_cell_labels(arena.boards[i], board_rects[i]);
+    }
+    ImGui::End();
+  }
+
+  ImGui::Render();
+  ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+}
+
 void UIManager::render_game_overlay(const GameBoard& board, int display_w,
-                                    int display_h) {
+                                    int display_h, bool draw_cell_labels,
+                                    const Hint* hint) {
   // Create an invisible overlay window that covers the game board area
   ImGui::SetNextWindowPos(ImVec2(0, UIConfig::kConsoleBarHeight));
   ImGui::SetNextWindowSize(
@@ -131,6 +241,43 @@ void UIManager::render_game_overlay(const GameBoard& board, int display_w,
 
   ImDrawList* draw_list = ImGui::GetWindowDrawList();
 
+  if (draw_cell_labels) {
+    render_cell_labels(board, BoardRect{0.0f, UIConfig::kConsoleBarHeight,
+                                        (float)display_w, board_height});
+  }
+
+  // Hint: proven safe cells in green, otherwise the best guess in yellow
+  if (hint) {
+    float thickness =
+        std::max(1.0f, std::min(cell_width, cell_height) * 0.08f);
+    auto outline = [&](const Hint::Point& point, ImU32 color) {
+      ImVec2 min(point.column * cell_width + thickness,
+                 UIConfig::kConsoleBarHeight + point.row * cell_height +
+                     thickness);
+      ImVec2 max(min.x + cell_width - 2 * thickness,
+                 min.y + cell_height - 2 * thickness);
+      draw_list->AddRect(min, max, color, 0.0f, 0, thickness);
+    };
+    for (const Hint::Point& point : hint->safe_cells) {
+      outline(point, IM_COL32(0, 255, 0, 255));
+    }
+    if (hint->has_guess) {
+      outline(hint->guess, IM_COL32(255, 255, 0, 255));
+    }
+  }
+
+  ImGui::End();
+}
+
+void UIManager::render_cell_labels(const GameBoard& board,
+                                   const BoardRect& rect) {
+  unsigned int rows = board.get_rows();
+  unsigned int cols = board.get_columns();
+  float cell_width = rect.width / cols;
+  float cell_height = rect.height / rows;
+
+  ImDrawList* draw_list = ImGui::GetWindowDrawList();
+
   // Use custom loaded font for numbers - scale based on cell size
   ImFont* font = large_font_ ? large_font_ : ImGui::GetFont();
   float font_size = cell_height * 0.6f;  // Use 60% of cell height for font size
@@ -144,15 +291,15 @@ void UIManager::render_game_overlay(const GameBoard& board, int display_w,
         continue;
       }
 
-      float x = col * cell_width + cell_width / 2.0f;
-      float y =
-          UIConfig::kConsoleBarHeight + row * cell_height + cell_height / 2.0f;
+      float x = rect.x + col * cell_width + cell_width / 2.0f;
+      float y = rect.y + row * cell_height + cell_height / 2.0f;
 
       if (cell.has_bomb()) {
         // Draw bomb symbol with larger font
-        draw_list->AddText(font, font_size,
-                           ImVec2(x - font_size * 0.3f, y - font_size * 0.5f),
-                           IM_COL32(255, 0, 0, 255), "B");
+        draw_list->AddText(
+            font, font_size,
+            ImVec2(x - font_size * 0.3f, y - font_size * 0.5f),
+            IM_COL32(255, 0, 0, 255), "B");
       } else if (cell.get_bomb_count() > 0) {
         // Draw number
         char num_str[2];
@@ -189,12 +336,39 @@ void UIManager::render_game_overlay(const GameBoard& board, int display_w,
             color = IM_COL32(0, 0, 0, 255);
         }
 
-        draw_list->AddText(font, font_size,
-                           ImVec2(x - font_size * 0.3f, y - font_size * 0.5f),
-                           color, num_str);
+        draw_list->AddText(
+            font, font_size,
+            ImVec2(x - font_size * 0.3f, y - font_size * 0.5f), color,
+            num_str);
       }
     }
   }
+}
+
+void UIManager::render_allocation_panel(
+    const AllocSnapshot& frame_allocations, int display_h) {
+  ImGui::SetNextWindowPos(ImVec2(10.0f, display_h - 150.0f));
+  ImGui::Begin("Allocations", nullptr,
+               ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove |
+                   ImGuiWindowFlags_NoCollapse |
+                   ImGuiWindowFlags_AlwaysAutoResize);
+
+  AllocCounters frame_total = frame_allocations.total();
+  ImGui::Text("Last frame: %llu allocations, %llu bytes",
+              (unsigned long long)frame_total.allocations,
+              (unsigned long long)frame_total.bytes);
+  ImGui::Separator();
+  for (std::size_t i = 0; i < kAllocTagCount; ++i) {
+    const AllocCounters& counters = frame_allocations.tags[i];
+    ImGui::Text("%-7s %6llu allocs %10llu bytes %6llu frees",
+                alloc_tag_name(static_cast<AllocTag>(i)),
+                (unsigned long long)counters.allocations,
+                (unsigned long long)counters.bytes,
+                (unsigned long long)counters.frees);
+  }
+  ImGui::Separator();
+  ImGui::Text("Since start: %llu allocations",
+              (unsigned long long)alloc_snapshot().total().allocations);
 
   ImGui::End();
 }
@@ -3,7 +3,12 @@
 
 #include <GLFW/glfw3.h>
 
+#include "alloc_tracker.h"
+#include "bot_arena.h"
 #include "game_board.h"
+#include "game_settings.h"
+#include "hint_engine.h"
+#include "stats_store.h"
 
 struct ImFont;  // Forward declaration
 
@@ -15,8 +20,19 @@ class UIManager {
   // Initialize ImGui
   bool initialize();
 
-  // Render UI for the current frame
-  void render(const GameBoard& board);
+  // Render UI for the current frame, with the finished-game records from
+  // stats. The cell numbers are skipped unless draw_cell_labels is set, and
+  // hint (if not null) is highlighted on the board. frame_allocations, if
+  // not null, is shown in a debug panel.
+  void render(const GameBoard& board, const StatsStore& stats,
+              bool draw_cell_labels, const Hint* hint,
+              const AllocSnapshot* frame_allocations);
+
+  // Render the console bar of the spectator view, with the arena's totals.
+  // If board_rects is not null, also draw the cell numbers of each board in
+  // its rectangle.
+  void render_spectator(const ArenaSnapshot& arena,
+                        const BoardRect* board_rects);
 
   // Cleanup ImGui resources
   void cleanup();
@@ -28,7 +44,15 @@ class UIManager {
 
   // Render numbers and symbols overlay on game board
   void render_game_overlay(const GameBoard& board, int display_w,
-                           int display_h);
+                           int display_h, bool draw_cell_labels,
+                           const Hint* hint);
+
+  // Numbers and bombs of the open cells of a board drawn in rect
+  void render_cell_labels(const GameBoard& board, const BoardRect& rect);
+
+  // Heap allocations of the last frame, per subsystem
+  void render_allocation_panel(const AllocSnapshot& frame_allocations,
+                               int display_h);
 };
 
 #endif  // UI_MANAGER_H_
@@ -0,0 +1,19 @@
+#ifndef VIEW_OPTIONS_H_
+#define VIEW_OPTIONS_H_
+
+// Display toggles, owned by main and flipped by the InputHandler on the
+// render thread
+struct ViewOptions {
+  // Draw the board from a one-byte-per-cell texture in a single full-screen
+  // pass (G toggles). Off: one quad per cell plus ImGui text for the numbers.
+  bool gpu_board = true;
+
+  // Highlight safe cells or the best guess, computed in the background
+  // (H toggles)
+  bool hints = false;
+
+  // Heap allocations per subsystem for the last frame (F3 toggles)
+  bool allocation_panel = false;
+};
+
+#endif  // VIEW_OPTIONS_H_